@@ -6,122 +6,96 @@
 #include <pthread.h>
 #include <sys/time.h>
 
+#include "../common/sudoku_check.h"
+#include "../common/sudoku_cols.h"
+#include "../common/sudoku_fused.h"
+#include "../common/log_arena.h"
+#include "../common/thread_pool.h"
+#include "../common/grid_io.h"
+
+#define COL_BLOCK 64 // columns a column task checks in one pass before it looks at the stop flag again
+
+typedef struct
+    {
+        // this struct is shared by all the tasks of one method so they can stop once the sudoku is known
+        // to be invalid
+
+        int invalid_found;      // set (atomically) by the first task that finds an invalid region
+        struct timeval start;   // when the method started
+        double first_rejection; // microseconds from start until invalid_found was set
+
+    } early_stop;
+
 typedef struct
     {
         // this struct is made to send as an input to thread functions
 
-        int **grid;        // sudoku
+        const sudoku_grid *grid; // sudoku
         int size;          // dimension(Row/Column)
         int t_id;          // thread id
         int no_of_threads; // total number of threads
 
         int t_offset;   // just a variable to differentiate between threads(which check rows,columns,subgrids)
         bool result;    // whether the result of the thread is valid/invalid.
-        char *messages; // a buffer created to display all the messages in the output file
+        log_arena messages; // a buffer created to display all the messages in the output file
+
+        early_stop *stop;   // shared with the other tasks of the method
+        int poll;           // the stop flag is read every 'poll' rows/column blocks/subgrids, 0 never stops early
 
     } t_input;
 
 FILE *out_file; // global declaration of output file
 
-bool check_for_row(int size, int **array, int row)
+void signal_invalid(t_input *inp)
     {
-        // this function validates one row at a time
+        // this function tells the other tasks that the sudoku is invalid. only the first call records the
+        // time to the first rejection.
 
-        bool *numbers = (bool *)malloc(size * sizeof(bool)); // an array which stores whether the numbers 1 to N-1 are encountered or not.
+        int expected = 0;
 
-        for (int i = 0; i < size; i++)
+        if (__atomic_compare_exchange_n(&inp->stop->invalid_found, &expected, 1, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
             {
-                // initialising all numbers as not encountered.
-
-                numbers[i] = false;
-            }
-
-        bool output = true; // output variable to store whether entire row is valid/invalid.
-
-        for (int col = 0; col < size; col++) // iterating through all
-            {
-                int read_num = array[row][col]; // variable that reads the number from sudoku
-
-                if (numbers[read_num - 1])
-                    {
-                        // case when we read an already encountered number.
-
-                        output = false;
-                        break;
-                    }
+                struct timeval now;
+                gettimeofday(&now, NULL);
 
-                numbers[read_num - 1] = true; // making the recently read number as encountered.
+                inp->stop->first_rejection = (now.tv_sec - inp->stop->start.tv_sec) * 1e6 + (now.tv_usec - inp->stop->start.tv_usec);
             }
-
-        free(numbers);
-        return output;
     }
 
-bool check_for_col(int size, int **array, int col)
+bool stop_requested(t_input *inp, int done)
     {
-        // this function validates one column at a time. Rest logic is same as that of checking rows.
-
-        bool *numbers = (bool *)malloc(size * sizeof(bool));
+        // this function is called before every unit of work, done is the number of units this task has
+        // finished. the shared flag is only read every inp->poll units.
 
-        for (int i = 0; i < size; i++)
+        if (inp->poll <= 0 || done % inp->poll != 0 || !__atomic_load_n(&inp->stop->invalid_found, __ATOMIC_RELAXED))
             {
-                numbers[i] = false;
+                return false;
             }
 
-        bool output = true;
+        log_arena_printf(&inp->messages, "Thread %d stops early, an invalid region was already found.\n", inp->t_id + inp->t_offset + 1);
+        return true;
+    }
 
-        for (int row = 0; row < size; row++)
-            {
-                int read_num = array[row][col];
+bool check_for_row(const sudoku_grid *grid, int row)
+    {
+        // this function validates one row at a time
 
-                if (numbers[read_num - 1])
-                    {
-                        output = false;
-                        break;
-                    }
+        return sudoku_check_row(grid, row);
+    }
 
-                numbers[read_num - 1] = true;
-            }
+void check_for_cols(const sudoku_grid *grid, int first, int last, int step, bool *col_valid)
+    {
+        // this function validates the columns first, first + step, ... below last in a single row by row
+        // pass over the grid. the verdict of the k-th of these columns is stored in col_valid[k].
 
-        free(numbers);
-        return output;
+        sudoku_check_cols_step(grid, first, last, step, col_valid);
     }
 
-bool check_for_subgrid(int size, int **array, int row, int col)
+bool check_for_subgrid(const sudoku_grid *grid, int row, int col)
     {
         // this function validates one subgrid at a time.
 
-        int n = sqrt(size); // variable that stores the dimension(length) of each subgrid
-
-        bool *numbers = (bool *)malloc(size * sizeof(bool));
-
-        for (int i = 0; i < size; i++)
-            {
-                numbers[i] = false;
-            }
-
-        bool output = true;
-
-        // iteration stops once it checks 'n' numbers along any dimension.
-
-        for (int i = row; i < row + n; i++)
-            {
-                for (int j = col; j < col + n; j++)
-                    {
-                        int read_num = array[i][j];
-
-                        if (numbers[read_num - 1])
-                            {
-                                output = false;
-                                break;
-                            }
-
-                        numbers[read_num - 1] = true;
-                    }
-            }
-
-        free(numbers);
-        return output;
+        return sudoku_check_subgrid(grid, row, col);
     }
 
 void *check_rows_chunk(void *param)
@@ -149,22 +123,59 @@ void *check_rows_chunk(void *param)
 
         for (int i = starting_pt; i < end; i++)
             {
-                bool validity = check_for_row(inp->size, inp->grid, i); // temporary variable to track if a particular row is valid/invalid
+                if (stop_requested(inp, i - starting_pt))
+                    {
+                        // another task already found an invalid region
+                        break;
+                    }
+
+                bool validity = check_for_row(inp->grid, i); // temporary variable to track if a particular row is valid/invalid
 
-                char temp[1000]; // temporary array to store message buffers
-                sprintf(temp, "Thread %d checks row %d and is %s.\n", inp->t_id + 1, i + 1, (validity) ? "valid" : "invalid");
-                strcat(inp->messages, temp);
+                log_arena_printf(&inp->messages, "Thread %d checks row %d and is %s.\n", inp->t_id + 1, i + 1, (validity) ? "valid" : "invalid"); // appending to this thread's arena
 
                 if (!validity)
                     {
-                        // updating the validness of a particular row
+                        // updating the validness of a particular row and letting the other tasks know
                         inp->result = false;
+                        signal_invalid(inp);
                     }
             }
 
         return NULL;
     }
 
+void check_cols_range(t_input *inp, int starting_pt, int end, int step)
+    {
+        // this function checks the columns starting_pt, starting_pt + step, ... below end for one task.
+        // they are checked COL_BLOCK at a time so the task can look at the stop flag between blocks.
+
+        bool col_valid[COL_BLOCK]; // verdicts of the columns of the current block
+
+        for (int block = 0, first = starting_pt; first < end; block++, first += COL_BLOCK * step)
+            {
+                if (stop_requested(inp, block))
+                    {
+                        break;
+                    }
+
+                int last = (first + COL_BLOCK * step < end) ? first + COL_BLOCK * step : end;
+                check_for_cols(inp->grid, first, last, step, col_valid);
+
+                for (int i = first, k = 0; i < last; i += step, k++)
+                    {
+                        bool validity = col_valid[k];
+
+                        log_arena_printf(&inp->messages, "Thread %d checks col %d and is %s.\n", inp->t_id + inp->t_offset + 1, i + 1, (validity) ? "valid" : "invalid");
+
+                        if (!validity)
+                            {
+                                inp->result = false;
+                                signal_invalid(inp);
+                            }
+                    }
+            }
+    }
+
 void *check_cols_chunk(void *param)
     {
         // this function checks all the columns using chunk method. Underlying logic is same as that of rows
@@ -186,20 +197,7 @@ void *check_cols_chunk(void *param)
             }
 
         inp->result = true;
-
-        for (int i = starting_pt; i < end; i++)
-            {
-                bool validity = check_for_col(inp->size, inp->grid, i);
-
-                char temp[1000];
-                sprintf(temp, "Thread %d checks col %d and is %s.\n", inp->t_id + inp->t_offset + 1, i + 1, (validity) ? "valid" : "invalid");
-                strcat(inp->messages, temp);
-
-                if (!validity)
-                    {
-                        inp->result = false;
-                    }
-            }
+        check_cols_range(inp, starting_pt, end, 1);
 
         return NULL;
     }
@@ -229,18 +227,22 @@ void *check_subgrids_chunk(void *param)
 
         for (int i = starting_pt; i < end; i++)
             {
+                if (stop_requested(inp, i - starting_pt))
+                    {
+                        break;
+                    }
+
                 int row = (i / n) * n; // obtaining row and column of grid using iteration variables.
                 int col = (i % n) * n;
 
-                bool validity = check_for_subgrid(inp->size, inp->grid, row, col);
+                bool validity = check_for_subgrid(inp->grid, row, col);
 
-                char temp[1000];
-                sprintf(temp, "Thread %d checks grid %d and is %s.\n", inp->t_id + inp->t_offset + 1, i + 1, (validity) ? "valid" : "invalid");
-                strcat(inp->messages, temp);
+                log_arena_printf(&inp->messages, "Thread %d checks grid %d and is %s.\n", inp->t_id + inp->t_offset + 1, i + 1, (validity) ? "valid" : "invalid");
 
                 if (!validity)
                     {
                         inp->result = false;
+                        signal_invalid(inp);
                     }
             }
 
@@ -254,19 +256,23 @@ void *check_rows_mixed(void *param)
         t_input *inp = (t_input *)param;
         inp->result = true;
 
-        for (int i = inp->t_id; i < inp->size; i += inp->no_of_threads)
+        for (int i = inp->t_id, done = 0; i < inp->size; i += inp->no_of_threads, done++)
             {
                 // implementing mixed method
 
-                bool validity = check_for_row(inp->size, inp->grid, i); // to check if a particular row is valid
+                if (stop_requested(inp, done))
+                    {
+                        break;
+                    }
 
-                char temp[1000];
-                sprintf(temp, "Thread %d checks row %d and is %s.\n", inp->t_id + 1, i + 1, (validity) ? "valid" : "invalid");
-                strcat(inp->messages, temp);
+                bool validity = check_for_row(inp->grid, i); // to check if a particular row is valid
+
+                log_arena_printf(&inp->messages, "Thread %d checks row %d and is %s.\n", inp->t_id + 1, i + 1, (validity) ? "valid" : "invalid");
 
                 if (!validity)
                     {
                         inp->result = false;
+                        signal_invalid(inp);
                     }
             }
 
@@ -279,20 +285,7 @@ void *check_cols_mixed(void *param)
 
         t_input *inp = (t_input *)param;
         inp->result = true;
-
-        for (int i = inp->t_id; i < inp->size; i += inp->no_of_threads)
-            {
-                bool validity = check_for_col(inp->size, inp->grid, i);
-
-                char temp[1000];
-                sprintf(temp, "Thread %d checks col %d and is %s.\n", inp->t_id + inp->t_offset + 1, i + 1, (validity) ? "valid" : "invalid");
-                strcat(inp->messages, temp);
-
-                if (!validity)
-                    {
-                        inp->result = false;
-                    }
-            }
+        check_cols_range(inp, inp->t_id, inp->size, inp->no_of_threads);
 
         return NULL;
     }
@@ -306,53 +299,64 @@ void *check_subgrids_mixed(void *param)
 
         inp->result = true;
 
-        for (int i = inp->t_id; i < inp->size; i += inp->no_of_threads)
+        for (int i = inp->t_id, done = 0; i < inp->size; i += inp->no_of_threads, done++)
             {
+                if (stop_requested(inp, done))
+                    {
+                        break;
+                    }
+
                 int row = (i / n) * n;
                 int col = (i % n) * n;
 
-                bool validity = check_for_subgrid(inp->size, inp->grid, row, col);
+                bool validity = check_for_subgrid(inp->grid, row, col);
 
-                char temp[1000];
-                sprintf(temp, "Thread %d checks grid %d and is %s.\n", inp->t_id + inp->t_offset + 1, i + 1, (validity) ? "valid" : "invalid");
-                strcat(inp->messages, temp);
+                log_arena_printf(&inp->messages, "Thread %d checks grid %d and is %s.\n", inp->t_id + inp->t_offset + 1, i + 1, (validity) ? "valid" : "invalid");
 
                 if (!validity)
                     {
                         inp->result = false;
+                        signal_invalid(inp);
                     }
             }
 
         return NULL;
     }
 
-bool check_for_sudoku(int size, int **array, int no_of_threads, bool do_chunk)
+bool check_for_sudoku(const sudoku_grid *array, thread_pool *pool, t_input *inps, int no_of_threads, bool do_chunk, int poll, bool quiet, double pool_startup)
     {
         // this function checks if entire Sudoku is valid using both the chunk and mixed methods.
+        // the work units are run as tasks on the persistent pool, inps holds no_of_threads structs and is
+        // reused by every call. pool_startup is the time it took to create the pool. all tasks stop once
+        // one of them finds an invalid region, they look for that every 'poll' units (0 turns it off).
+        // with quiet set the tasks do not write their messages.
+
+        int size = array->size;
 
-        int msg_size = 200 * size; // declaring the size of each message to be buffered.
+        size_t msg_size = 48; // rough size of one message, used to size each thread's arena up front
 
         int threads_for_rows = no_of_threads / 3; // dividing total number of threads into three sets
         int threads_for_cols = no_of_threads / 3;
         int threads_for_subgrids = no_of_threads - threads_for_cols - threads_for_rows;
 
-        pthread_t *row_t_ids = malloc(threads_for_rows * sizeof(pthread_t)); // creating arrays to store thread ids.
-        pthread_t *col_t_ids = malloc(threads_for_cols * sizeof(pthread_t));
-        pthread_t *subgrid_t_ids = malloc(threads_for_subgrids * sizeof(pthread_t));
-
-        t_input *row_inps = malloc(threads_for_rows * sizeof(t_input)); // creating an array of structs in order to input to the thread functions
-        t_input *col_inps = malloc(threads_for_cols * sizeof(t_input));
-        t_input *subgrid_inps = malloc(threads_for_subgrids * sizeof(t_input));
-
-        pthread_attr_t attr; // obtaining default thread attributes
-        pthread_attr_init(&attr);
+        t_input *row_inps = inps; // splitting the array of structs that are input to the thread functions
+        t_input *col_inps = row_inps + threads_for_rows;
+        t_input *subgrid_inps = col_inps + threads_for_cols;
 
         struct timeval start, end; // starting the time
         gettimeofday(&start, NULL);
 
+        early_stop stop = {0, start, 0};
+
+        for (int i = 0; i < no_of_threads; i++)
+            {
+                inps[i].stop = &stop;
+                inps[i].poll = poll;
+            }
+
         for (int i = 0; i < threads_for_rows; i++)
             {
-                // this for loop creates all threads that validate rows
+                // this for loop submits all tasks that validate rows
 
                 row_inps[i].grid = array; // initialising the parameters present in struct
                 row_inps[i].size = size;
@@ -360,25 +364,25 @@ bool check_for_sudoku(int size, int **array, int no_of_threads, bool do_chunk)
                 row_inps[i].no_of_threads = threads_for_rows;
 
                 row_inps[i].t_offset = 0;
-                row_inps[i].messages = (char *)malloc(msg_size * sizeof(char)); // dynamically allocating memory for message buffer
-                row_inps[i].messages[0] = '\0';                                 // initialising it to a null character
+                log_arena_init(&row_inps[i].messages, msg_size * (size / threads_for_rows + 1)); // one arena per thread, sized for its share of rows
+                log_arena_mute(&row_inps[i].messages, quiet);
 
                 if (do_chunk)
                     {
                         // if we want to validate using chunk method
 
-                        pthread_create(&row_t_ids[i], &attr, check_rows_chunk, &row_inps[i]);
+                        thread_pool_submit(pool, check_rows_chunk, &row_inps[i]);
                     }
 
                 else
                     {
-                        pthread_create(&row_t_ids[i], &attr, check_rows_mixed, &row_inps[i]);
+                        thread_pool_submit(pool, check_rows_mixed, &row_inps[i]);
                     }
             }
 
         for (int i = 0; i < threads_for_cols; i++)
             {
-                // column thread creation similar to row threads
+                // column tasks similar to row tasks
 
                 col_inps[i].grid = array;
                 col_inps[i].size = size;
@@ -386,23 +390,23 @@ bool check_for_sudoku(int size, int **array, int no_of_threads, bool do_chunk)
                 col_inps[i].no_of_threads = threads_for_cols;
 
                 col_inps[i].t_offset = threads_for_rows;
-                col_inps[i].messages = (char *)malloc(msg_size * sizeof(char));
-                col_inps[i].messages[0] = '\0';
+                log_arena_init(&col_inps[i].messages, msg_size * (size / threads_for_cols + 1));
+                log_arena_mute(&col_inps[i].messages, quiet);
 
                 if (do_chunk)
                     {
-                        pthread_create(&col_t_ids[i], &attr, check_cols_chunk, &col_inps[i]);
+                        thread_pool_submit(pool, check_cols_chunk, &col_inps[i]);
                     }
 
                 else
                     {
-                        pthread_create(&col_t_ids[i], &attr, check_cols_mixed, &col_inps[i]);
+                        thread_pool_submit(pool, check_cols_mixed, &col_inps[i]);
                     }
             }
 
         for (int i = 0; i < threads_for_subgrids; i++)
             {
-                // subgrid threads creation
+                // subgrid tasks
 
                 subgrid_inps[i].grid = array;
                 subgrid_inps[i].size = size;
@@ -410,30 +414,31 @@ bool check_for_sudoku(int size, int **array, int no_of_threads, bool do_chunk)
                 subgrid_inps[i].no_of_threads = threads_for_subgrids;
 
                 subgrid_inps[i].t_offset = threads_for_rows + threads_for_cols;
-                subgrid_inps[i].messages = (char *)malloc(msg_size * sizeof(char));
-                subgrid_inps[i].messages[0] = '\0';
+                log_arena_init(&subgrid_inps[i].messages, msg_size * (size / threads_for_subgrids + 1));
+                log_arena_mute(&subgrid_inps[i].messages, quiet);
 
                 if (do_chunk)
                     {
-                        pthread_create(&subgrid_t_ids[i], &attr, check_subgrids_chunk, &subgrid_inps[i]);
+                        thread_pool_submit(pool, check_subgrids_chunk, &subgrid_inps[i]);
                     }
 
                 else
                     {
-                        pthread_create(&subgrid_t_ids[i], &attr, check_subgrids_mixed, &subgrid_inps[i]);
+                        thread_pool_submit(pool, check_subgrids_mixed, &subgrid_inps[i]);
                     }
             }
 
         bool validity = true; // variable to check if the entire sudoku is valid
 
-        for (int i = 0; i < threads_for_rows; i++)
-            {
-                // waiting for row threads to join
+        thread_pool_wait(pool); // waiting for every task to finish
 
-                pthread_join(row_t_ids[i], NULL);
+        struct timeval validated; // everything after this is writing the messages
+        gettimeofday(&validated, NULL);
 
-                fprintf(out_file, "%s", row_inps[i].messages); // printing the message of threads in order
-                free(row_inps[i].messages);                      // freeing the memory allocated to messages while thread creation
+        for (int i = 0; i < threads_for_rows; i++)
+            {
+                log_arena_flush(&row_inps[i].messages, out_file); // printing the message of threads in order, one write per thread
+                log_arena_free(&row_inps[i].messages);             // freeing the memory allocated to messages while thread creation
 
                 if (!row_inps[i].result)
                     {
@@ -445,12 +450,10 @@ bool check_for_sudoku(int size, int **array, int no_of_threads, bool do_chunk)
 
         for (int i = 0; i < threads_for_cols; i++)
             {
-                // Waiting for column threads to join and printing the output
-
-                pthread_join(col_t_ids[i], NULL);
+                // printing the output of column tasks
 
-                fprintf(out_file, "%s", col_inps[i].messages);
-                free(col_inps[i].messages);
+                log_arena_flush(&col_inps[i].messages, out_file);
+                log_arena_free(&col_inps[i].messages);
 
                 if (!col_inps[i].result)
                     {
@@ -462,10 +465,8 @@ bool check_for_sudoku(int size, int **array, int no_of_threads, bool do_chunk)
             {
                 // similar tp above loops, but applies for subgrids
 
-                pthread_join(subgrid_t_ids[i], NULL);
-
-                fprintf(out_file, "%s", subgrid_inps[i].messages);
-                free(subgrid_inps[i].messages);
+                log_arena_flush(&subgrid_inps[i].messages, out_file);
+                log_arena_free(&subgrid_inps[i].messages);
 
                 if (!subgrid_inps[i].result)
                     {
@@ -478,64 +479,306 @@ bool check_for_sudoku(int size, int **array, int no_of_threads, bool do_chunk)
         time_calculated = (time_calculated + (end.tv_usec - start.tv_usec));
 
         fprintf(out_file, "The total time taken is %.2f microseconds.\n", time_calculated); // printing the total time taken
+        fprintf(out_file, "The total time taken including thread pool startup is %.2f microseconds.\n", time_calculated + pool_startup);
+        fprintf(out_file, "The time taken for validation is %.2f microseconds.\n", (validated.tv_sec - start.tv_sec) * 1e6 + (validated.tv_usec - start.tv_usec));
 
-        free(row_inps); // Cleaning all the memories
-        free(col_inps);
-        free(subgrid_inps);
-        free(row_t_ids);
-        free(col_t_ids);
-        free(subgrid_t_ids);
+        if (stop.invalid_found)
+            {
+                fprintf(out_file, "The time taken to the first rejection is %.2f microseconds.\n", stop.first_rejection);
+            }
 
         return validity; // returning the validness of Sudoku
     }
 
-bool check_sudoku_sequential(int size, int **array)
+bool check_sudoku_sequential(const sudoku_grid *array)
     {
-        // this function checks if the entire sudoku is valid without any threads
+        // this function checks if the entire sudoku is valid without any threads. every cell is read once
+        // and updates its row, column and subgrid at the same time.
 
-        bool validity = true;
-        int n = sqrt(size);
+        struct timeval start, end;
+        gettimeofday(&start, NULL);
+
+        bool validity = sudoku_check_fused(array);
+
+        gettimeofday(&end, NULL); // time calculation
+        double time_calculated = (end.tv_sec - start.tv_sec) * 1e6;
+        time_calculated = (time_calculated + (end.tv_usec - start.tv_usec));
+
+        fprintf(out_file, "The total time taken is %.2f microseconds.\n", time_calculated); // printing the output
+
+        return validity;
+    }
+
+bool check_sudoku_fused(const sudoku_grid *array, thread_pool *pool, int no_of_threads, double pool_startup)
+    {
+        // this function checks the entire sudoku in one pass with the rows split into one band per thread.
+        // the bands run on the pool and merge their column and subgrid masks when they finish.
 
         struct timeval start, end;
         gettimeofday(&start, NULL);
 
-        for (int i = 0; i < size; i++)
+        bool validity = sudoku_check_fused_parallel(array, no_of_threads, pool);
+
+        gettimeofday(&end, NULL);
+        double time_calculated = (end.tv_sec - start.tv_sec) * 1e6;
+        time_calculated = (time_calculated + (end.tv_usec - start.tv_usec));
+
+        fprintf(out_file, "The total time taken is %.2f microseconds.\n", time_calculated);
+        fprintf(out_file, "The total time taken including thread pool startup is %.2f microseconds.\n", time_calculated + pool_startup);
+
+        return validity;
+    }
+
+#define BATCH_CHUNK 4096 // puzzles read and validated per round in batch mode
+
+typedef struct
+    {
+        // this struct is one slice of a batch round, handed to a pool task
+
+        const sudoku_grid *grids; // puzzles of the round
+        bool *verdicts;           // verdict of every puzzle of the round
+        int first;                // puzzles [first, last) belong to this slice
+        int last;
+
+        uint64_t *masks;          // column and subgrid masks of the single pass validator, kept for every round
+        size_t mask_words;        // uint64_t words masks holds
+
+    } batch_slice;
+
+void *check_batch_slice(void *param)
+    {
+        // this function validates every puzzle of one slice on its own, with the single pass validator.
+        // the slice's masks only grow when a puzzle is larger than every one before it, so a batch of
+        // same sized puzzles allocates nothing after the first.
+
+        batch_slice *slice = (batch_slice *)param;
+
+        for (int i = slice->first; i < slice->last; i++)
             {
-                // this loop checks if any one row or column is invalid
+                const sudoku_grid *grid = &slice->grids[i];
+                size_t words = (size_t)grid->size * digit_set_words(grid->size);
 
-                if (!check_for_row(size, array, i) || !check_for_col(size, array, i))
+                if (2 * words > slice->mask_words)
                     {
-                        // if any row/column is invalid, update the validness
+                        uint64_t *masks = realloc(slice->masks, 2 * words * sizeof(uint64_t));
 
-                        validity = false;
+                        if (masks == NULL)
+                            {
+                                slice->verdicts[i] = sudoku_check_fused(grid);
+                                continue;
+                            }
+
+                        slice->masks = masks;
+                        slice->mask_words = 2 * words;
                     }
+
+                slice->verdicts[i] = sudoku_check_fused_masks(grid, slice->masks, slice->masks + words);
             }
 
-        for (int i = 0; i < size; i += n) // this loop checks if any subgrid is invalid and if so then update the validness
+        return NULL;
+    }
+
+int check_sudoku_batch(const char *path, int no_of_threads)
+    {
+        // this function validates a whole file of puzzles, either inp.txt style puzzles back to back or a
+        // binary grid file. the parallelism is across puzzles: each round reads up to BATCH_CHUNK puzzles,
+        // splits them into one slice per pool thread and writes one verdict per puzzle. the pool is started
+        // once for the whole file. no_of_threads <= 0 takes K from the first puzzle.
+
+        sudoku_source inp_file; // text puzzles are parsed into the slots, binary grids are viewed in place
+
+        if (!sudoku_source_open(&inp_file, path))
+            {
+                printf("ERROR: Something went wrong opening %s\n", path);
+                return -1;
+            }
+
+        out_file = fopen("batch_output.txt", "w");
+
+        if (out_file == NULL)
+            {
+                printf("ERROR: Something went wrong opening batch_output.txt\n");
+                sudoku_source_close(&inp_file);
+                return -1;
+            }
+
+        sudoku_grid *grids = calloc(BATCH_CHUNK, sizeof(sudoku_grid)); // slots reused by every round
+        bool *verdicts = malloc(BATCH_CHUNK * sizeof(bool));
+
+        if (grids == NULL || verdicts == NULL)
+            {
+                printf("ERROR: Something went wrong allocating room for %d puzzles\n", BATCH_CHUNK);
+                free(grids);
+                free(verdicts);
+                sudoku_source_close(&inp_file);
+                fclose(out_file);
+                return -1;
+            }
+
+        struct timeval start, end, round_start, round_end;
+        gettimeofday(&start, NULL);
+
+        thread_pool pool;
+        bool pool_started = false;
+        batch_slice *slices = NULL;
+
+        long puzzles = 0, valid_puzzles = 0;
+        double validation_time = 0;
+        int status = 0;     // 1 => end of the file, -1 => a malformed puzzle, -2 => the threads could not be started
+
+        while (status == 0)
             {
-                for (int j = 0; j < size; j += n)
+                // reading one round
+
+                int count = 0;
+
+                while (count < BATCH_CHUNK)
                     {
-                        if (!check_for_subgrid(size, array, i, j))
+                        sudoku_header header;
+                        int read = sudoku_source_next(&inp_file, 2, &header, &grids[count]);
+                        int n = sqrt(header.size);
+
+                        if (read > 0 && n * n != header.size)
+                            {
+                                read = -1;
+                            }
+
+                        if (read <= 0)
+                            {
+                                status = (read < 0) ? -1 : 1;
+                                break;
+                            }
+
+                        if (no_of_threads <= 0)
                             {
-                                validity = false;
+                                no_of_threads = (header.threads > 0) ? header.threads : 1;
                             }
+
+                        count++;
+                    }
+
+                if (count == 0)
+                    {
+                        break;
+                    }
+
+                if (!pool_started)
+                    {
+                        slices = calloc(no_of_threads, sizeof(batch_slice)); // no masks yet
+
+                        if (slices == NULL || !thread_pool_init(&pool, no_of_threads))
+                            {
+                                status = -2;
+                                break;
+                            }
+
+                        pool_started = true;
+                    }
+
+                // validating the round, one slice per thread
+
+                gettimeofday(&round_start, NULL);
+
+                int chunk_size = (count + no_of_threads - 1) / no_of_threads;
+
+                for (int i = 0; i < no_of_threads; i++)
+                    {
+                        slices[i].grids = grids;
+                        slices[i].verdicts = verdicts;
+                        slices[i].first = (i * chunk_size < count) ? i * chunk_size : count;
+                        slices[i].last = (slices[i].first + chunk_size < count) ? slices[i].first + chunk_size : count;
+
+                        if (slices[i].first < slices[i].last)
+                            {
+                                thread_pool_submit(&pool, check_batch_slice, &slices[i]);
+                            }
+                    }
+
+                thread_pool_wait(&pool);
+
+                gettimeofday(&round_end, NULL);
+                validation_time += (round_end.tv_sec - round_start.tv_sec) * 1e6 + (round_end.tv_usec - round_start.tv_usec);
+
+                for (int i = 0; i < count; i++)
+                    {
+                        fprintf(out_file, "Puzzle %ld is %s.\n", puzzles + i + 1, (verdicts[i]) ? "valid" : "invalid");
+                        valid_puzzles += verdicts[i];
                     }
+
+                puzzles += count;
             }
 
-        gettimeofday(&end, NULL); // time calculation
-        double time_calculated = (end.tv_sec - start.tv_sec) * 1e6;
-        time_calculated = (time_calculated + (end.tv_usec - start.tv_usec));
+        gettimeofday(&end, NULL);
+        double total_time = (end.tv_sec - start.tv_sec) * 1e6 + (end.tv_usec - start.tv_usec);
 
-        fprintf(out_file, "The total time taken is %.2f microseconds.\n", time_calculated); // printing the output
+        if (status == -1)
+            {
+                fprintf(out_file, "ERROR: puzzle %ld is malformed, stopped reading.\n", puzzles + 1);
+                printf("ERROR: puzzle %ld is malformed, stopped reading.\n", puzzles + 1);
+            }
 
-        return validity;
+        else if (status == -2)
+            {
+                fprintf(out_file, "ERROR: Something went wrong starting %d threads\n", no_of_threads);
+                printf("ERROR: Something went wrong starting %d threads\n", no_of_threads);
+            }
+
+        fprintf(out_file, "%ld puzzles checked, %ld valid and %ld invalid.\n", puzzles, valid_puzzles, puzzles - valid_puzzles);
+        fprintf(out_file, "The total time taken for validation is %.2f microseconds (%.0f puzzles/second).\n", validation_time, (validation_time > 0) ? puzzles * 1e6 / validation_time : 0.0);
+        fprintf(out_file, "The total time taken including input and output is %.2f microseconds (%.0f puzzles/second).\n", total_time, (total_time > 0) ? puzzles * 1e6 / total_time : 0.0);
+
+        if (pool_started)
+            {
+                thread_pool_destroy(&pool);
+            }
+
+        for (int i = 0; i < BATCH_CHUNK; i++)
+            {
+                sudoku_grid_free(&grids[i]);
+            }
+
+        for (int i = 0; slices != NULL && i < no_of_threads; i++)
+            {
+                free(slices[i].masks);
+            }
+
+        free(grids);
+        free(verdicts);
+        free(slices);
+        sudoku_source_close(&inp_file);
+        fclose(out_file);
+
+        return (status < 0) ? -1 : 0;
     }
 
-int main()
+int main(int argc, char **argv)
     {
-        FILE *inp_file = fopen("inp.txt", "r");
+        if (argc >= 3 && strcmp(argv[1], "--batch") == 0)
+            {
+                // batch mode: ./a.out --batch <file> [threads]
+
+                return check_sudoku_batch(argv[2], (argc >= 4) ? atoi(argv[3]) : 0);
+            }
+
+        int poll = 1;       // ./a.out --poll <units> sets how often the threads look for an earlier rejection
+        bool quiet = false; // ./a.out --quiet leaves out the per thread messages, only results and times are written
+
+        for (int i = 1; i < argc; i++)
+            {
+                if (strcmp(argv[i], "--poll") == 0 && i + 1 < argc)
+                    {
+                        poll = atoi(argv[++i]);
+                    }
 
-        if (inp_file == NULL)
+                else if (strcmp(argv[i], "--quiet") == 0)
+                    {
+                        quiet = true;
+                    }
+            }
+
+        sudoku_source inp_file; // inp.txt is mapped, it may be text or the binary grid format
+
+        if (!sudoku_source_open(&inp_file, "inp.txt"))
             {
                 // if input file couldn't be opened
 
@@ -543,37 +786,29 @@ int main()
                 return -1;
             }
 
-        int no_of_threads, grid_size = 0;
-        fscanf(inp_file, "%d %d", &no_of_threads, &grid_size); // reading number of threads and sudoku size from input file
+        sudoku_header header;                          // number of threads and sudoku size from input file
+        sudoku_grid sudoku = {0, 1, 0, NULL, false};   // one contiguous block (or a view into the file) for the whole sudoku
 
-        int n = sqrt(grid_size);
-
-        if (n * n != grid_size)
+        if (sudoku_source_next(&inp_file, 2, &header, &sudoku) != 1)
             {
-                // if the value of N is not a perfect square
-
                 printf("ERROR: Invalid input format.\n");
-                fclose(inp_file);
+                sudoku_source_close(&inp_file);
                 return -1;
             }
 
-        int **sudoku = (int **)malloc(grid_size * sizeof(int *)); // allocating memory for sudoku
+        int no_of_threads = header.threads, grid_size = header.size;
+        int n = sqrt(grid_size);
 
-        for (int i = 0; i < grid_size; i++)
+        if (n * n != grid_size)
             {
-                sudoku[i] = (int *)malloc(grid_size * sizeof(int));
-            }
+                // if the value of N is not a perfect square
 
-        for (int i = 0; i < grid_size; i++)
-            {
-                for (int j = 0; j < grid_size; j++)
-                    {
-                        fscanf(inp_file, "%d", &sudoku[i][j]); // reading the sudoku from the file
-                    }
+                printf("ERROR: Invalid input format.\n");
+                sudoku_grid_free(&sudoku);
+                sudoku_source_close(&inp_file);
+                return -1;
             }
 
-        fclose(inp_file);
-
         out_file = fopen("output.txt", "w");
 
         if (out_file == NULL)
@@ -582,23 +817,52 @@ int main()
             }
 
         fprintf(out_file, "\t\tSequential method: \n");
-        bool sequential_result = check_sudoku_sequential(grid_size, sudoku);
+        bool sequential_result = check_sudoku_sequential(&sudoku);
         fprintf(out_file, "Validation result: %s.\n", (sequential_result) ? "valid" : "invalid");
 
+        struct timeval pool_start, pool_end; // the pool is started once and shared by the threaded methods
+        gettimeofday(&pool_start, NULL);
+
+        thread_pool pool;
+        bool pool_started = thread_pool_init(&pool, no_of_threads);
+
+        gettimeofday(&pool_end, NULL);
+        double pool_startup = (pool_end.tv_sec - pool_start.tv_sec) * 1e6 + (pool_end.tv_usec - pool_start.tv_usec);
+
+        t_input *inps = malloc(no_of_threads * sizeof(t_input)); // inputs of the thread functions, reused by every method
+
+        if (!pool_started || inps == NULL)
+            {
+                printf("ERROR: Something went wrong starting %d threads\n", no_of_threads);
+
+                if (pool_started)
+                    {
+                        thread_pool_destroy(&pool);
+                    }
+
+                fclose(out_file);
+                sudoku_grid_free(&sudoku);
+                sudoku_source_close(&inp_file);
+                return -1;
+            }
+
         fprintf(out_file, "\n\t\tChunk method: \n");
-        bool chunk_result = check_for_sudoku(grid_size, sudoku, no_of_threads, true);
+        bool chunk_result = check_for_sudoku(&sudoku, &pool, inps, no_of_threads, true, poll, quiet, pool_startup);
         fprintf(out_file, "Validation result: %s.\n", (chunk_result) ? "valid" : "invalid");
 
         fprintf(out_file, "\n\t\tMixed method: \n");
-        bool mixed_result = check_for_sudoku(grid_size, sudoku, no_of_threads, false);
+        bool mixed_result = check_for_sudoku(&sudoku, &pool, inps, no_of_threads, false, poll, quiet, pool_startup);
         fprintf(out_file, "Validation result: %s.\n", (mixed_result) ? "valid" : "invalid");
 
-        for (int i = 0; i < grid_size; i++) // Clearing the memory
-            {
-                free(sudoku[i]);
-            }
+        fprintf(out_file, "\n\t\tFused method: \n");
+        bool fused_result = check_sudoku_fused(&sudoku, &pool, no_of_threads, pool_startup);
+        fprintf(out_file, "Validation result: %s.\n", (fused_result) ? "valid" : "invalid");
+
+        thread_pool_destroy(&pool);
+        free(inps);
 
         fclose(out_file);
-        free(sudoku);
+        sudoku_grid_free(&sudoku); // Clearing the memory
+        sudoku_source_close(&inp_file);
         return 0;
     }
\ No newline at end of file
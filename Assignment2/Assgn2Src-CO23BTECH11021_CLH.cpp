@@ -0,0 +1,11 @@
+// the Assignment2 validator with the CLH queue lock. the program itself is run_task_validator in
+// common/task_validator.h with lock_dispatch (common/lock_dispatch.h), the lock is clh_lock in
+// common/lock_policies.h.
+// ./a.out [--quiet] [--numa]
+
+#include "../common/lock_dispatch.h"
+
+int main(int argc, char **argv)
+    {
+        return run_task_validator<lock_dispatch<clh_lock>>(argc, argv);
+    }
@@ -0,0 +1,42 @@
+// the Assignment2 validator with the tasks handed out by a lock-free fetch_add. the program itself is
+// run_task_validator in common/task_validator.h, this file only has the dispatch policy.
+// ./a.out [--quiet] [--numa] [--csv file]
+
+#include "../common/task_validator.h"
+
+struct faa_dispatch : task_policy
+    {
+        // every claim bumps the shared counter C by taskInc with one fetch_add, there is no critical
+        // section. C may end up past 3*N by at most K*taskInc, the range itself is clamped to 3*N.
+
+        static constexpr const char *name = "faa";
+        static constexpr const char *output = "outputFaa.txt";
+        static constexpr const char *claim_what = "claim tasks";
+
+        alignas(CACHE_LINE) std::atomic<int> C{0};      // the shared counter, only ever bumped with fetch_add
+        int tasks;                                      // 3*N
+        int task_inc;
+
+        faa_dispatch(int /* threads */, int size, int task_inc) : tasks(3 * size), task_inc(task_inc) {}
+
+        bool next(int thread, task_range *range, trace_buffer *trace)
+            {
+                int task_start = C.fetch_add(task_inc, std::memory_order_relaxed);
+
+                if (task_start >= tasks)
+                    {
+                        // if a thread claims after all the checks were handed out
+
+                        return false;
+                    }
+
+                *range = {task_start, std::min(task_start + task_inc, tasks)};
+                dispatch_log(trace, thread, TRACE_CLAIM, range->first + 1, range->last);
+                return true;
+            }
+    };
+
+int main(int argc, char **argv)
+    {
+        return run_task_validator<faa_dispatch>(argc, argv);
+    }
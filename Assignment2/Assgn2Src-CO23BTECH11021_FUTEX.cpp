@@ -0,0 +1,11 @@
+// the Assignment2 validator with the spin-then-park futex lock. the program itself is run_task_validator in
+// common/task_validator.h with lock_dispatch (common/lock_dispatch.h), the lock is futex_lock in
+// common/lock_policies.h.
+// ./a.out [--quiet] [--numa] [--spin steps]
+
+#include "../common/lock_dispatch.h"
+
+int main(int argc, char **argv)
+    {
+        return run_task_validator<lock_dispatch<futex_lock>>(argc, argv);
+    }
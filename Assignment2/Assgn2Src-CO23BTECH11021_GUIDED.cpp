@@ -0,0 +1,163 @@
+// the Assignment2 validator with guided chunks claimed without a critical section. the program itself is
+// run_task_validator in common/task_validator.h, this file only has the dispatch policy.
+// ./a.out [--quiet] [--numa] [--csv file] [--fixed] [--weights r,c,s]
+
+#include <memory>
+
+#include "../common/task_validator.h"
+
+struct guided_dispatch : task_policy
+    {
+        // a claim moves the shared counter C on with compare_exchange. the chunk size depends on where C
+        // is, so it is worked out from the value read and only taken if C still has that value.
+
+        static constexpr const char *name = "guided";
+        static constexpr const char *output = "outputGuided.txt";
+        static constexpr const char *claim_what = "claim tasks";
+
+        struct alignas(CACHE_LINE) claimer
+            {
+                int largest_chunk = 0;
+                double finish_time = 0;     // microseconds from the start of the threads until this one ran out of work
+            };
+
+        alignas(CACHE_LINE) std::atomic<int> C{0};      // the shared counter, moved on with compare_exchange
+        int no_of_threads;                              // K
+        int N;
+        int task_inc;
+        bool guided = true;                             // guided chunks, or fixed taskInc chunks with --fixed
+        double weights[3] = {1, 1, 1};                  // relative cost of a row, column and subgrid check (--weights r,c,s)
+        std::unique_ptr<claimer[]> claimers;
+
+        guided_dispatch(int threads, int size, int task_inc) : no_of_threads(threads), N(size), task_inc(task_inc), claimers(new claimer[threads]) {}
+
+        bool configure(int argc, char **argv)
+            {
+                // the weights divide the remaining cost in chunk_size, so each of them has to be a finite number above 0
+
+                for (int i = 1; i < argc; i++)
+                    {
+                        std::string arg = argv[i];
+
+                        if (arg == "--fixed")
+                            {
+                                guided = false;
+                            }
+
+                        else if (arg == "--weights" && i + 1 < argc)
+                            {
+                                bool usable = (sscanf(argv[++i], "%lf,%lf,%lf", &weights[0], &weights[1], &weights[2]) == 3);
+
+                                for (double weight : weights)
+                                    {
+                                        usable = usable && weight > 0 && std::isfinite(weight);
+                                    }
+
+                                if (!usable)
+                                    {
+                                        std::cout << "ERROR: --weights needs three finite weights above 0 (r,c,s)." << std::endl;
+                                        return false;
+                                    }
+                            }
+                    }
+
+                return true;
+            }
+
+        double remaining_cost(int task_start)
+            {
+                // weighted cost of the tasks [task_start, 3*N)
+
+                double cost = 0;
+
+                for (int kind = 0; kind < 3; kind++)
+                    {
+                        int first = std::max(task_start, kind * N);
+                        int last = (kind + 1) * N;
+
+                        if (first < last)
+                            {
+                                cost += (last - first) * weights[kind];
+                            }
+                    }
+
+                return cost;
+            }
+
+        int chunk_size(int task_start)
+            {
+                // guided scheduling: a claim takes about 1/K of the remaining cost, so chunks start large and shrink
+                // towards taskInc (the smallest chunk) as the work runs out. the cost is turned back into a number of
+                // tasks with the weight of the kind of task the chunk starts with.
+
+                int remaining = 3*N - task_start;
+                int size = task_inc;
+
+                if (guided)
+                    {
+                        double target = remaining_cost(task_start) / no_of_threads;
+                        size = std::max((int)ceil(target / weights[std::min(task_start / N, 2)]), task_inc);
+                    }
+
+                return std::max(std::min(size, remaining), 1);
+            }
+
+        bool next(int thread, task_range *range, trace_buffer *trace)
+            {
+                int task_start = C.load(std::memory_order_relaxed);
+                int task_end = task_start;
+
+                while (task_start < 3*N)
+                    {
+                        task_end = task_start + chunk_size(task_start);
+
+                        if (C.compare_exchange_weak(task_start, task_end, std::memory_order_relaxed))
+                            {
+                                break;
+                            }
+                    }
+
+                if (task_start >= 3*N)
+                    {
+                        // if a thread claims after all the checks were handed out
+
+                        return false;
+                    }
+
+                claimers[thread].largest_chunk = std::max(claimers[thread].largest_chunk, task_end - task_start);
+                *range = {task_start, task_end};
+                dispatch_log(trace, thread, TRACE_CLAIM, task_start + 1, task_end);
+                return true;
+            }
+
+        void finished(int thread, double elapsed)
+            {
+                claimers[thread].finish_time = elapsed;
+            }
+
+        void report(std::ostream &out)
+            {
+                // completion times, to see how evenly the work was spread
+
+                int largest_chunk = 0;
+                double earliest_finish = -1, latest_finish = 0, total_finish = 0;
+
+                for (int i = 0; i < no_of_threads; i++)
+                    {
+                        largest_chunk = std::max(largest_chunk, claimers[i].largest_chunk);
+                        earliest_finish = (earliest_finish < 0) ? claimers[i].finish_time : std::min(earliest_finish, claimers[i].finish_time);
+                        latest_finish = std::max(latest_finish, claimers[i].finish_time);
+                        total_finish += claimers[i].finish_time;
+                    }
+
+                out << "Scheduling: " << (guided ? "guided" : "fixed") << ", smallest chunk " << task_inc << ", largest chunk " << largest_chunk << ", weights " << weights[0] << "," << weights[1] << "," << weights[2] << std::endl;
+                out << "Earliest completion time of a thread: " << earliest_finish << " microseconds" << std::endl;
+                out << "Latest completion time of a thread: " << latest_finish << " microseconds" << std::endl;
+                out << "Completion time imbalance (latest - mean): " << latest_finish - total_finish / no_of_threads << " microseconds" << std::endl;
+            }
+    };
+
+int main(int argc, char **argv)
+    {
+        return run_task_validator<guided_dispatch>(argc, argv);
+    }
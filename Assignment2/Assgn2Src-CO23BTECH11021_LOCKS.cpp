@@ -0,0 +1,59 @@
+// the Assignment2 validator with the lock picked at run time, so one binary runs them all.
+// ./a.out --lock tas|ttas|ticket|mcs|clh|cas|bcas|futex|cohort [--quiet] [--numa] [--csv file] [--spin steps]
+//     [--budget handoffs] [--cohorts count]
+// each lock writes the same file as its own program (outputTas.txt, ...).
+
+#include <cstring>
+
+#include "../common/lock_dispatch.h"
+
+template <class Lock>
+bool run_if_named(const char *name, int argc, char **argv, int *status)
+    {
+        // runs the validator with Lock if name is its --lock name
+
+        if (strcmp(name, Lock::name) != 0)
+            {
+                return false;
+            }
+
+        *status = run_task_validator<lock_dispatch<Lock>>(argc, argv);
+        return true;
+    }
+
+int main(int argc, char **argv)
+    {
+        const char *name = nullptr;
+
+        for (int i = 1; i + 1 < argc; i++)
+            {
+                if (strcmp(argv[i], "--lock") == 0)
+                    {
+                        name = argv[i + 1];
+                    }
+            }
+
+        if (name == nullptr)
+            {
+                std::cout << "ERROR: --lock tas|ttas|ticket|mcs|clh|cas|bcas|futex|cohort is required." << std::endl;
+                return -1;
+            }
+
+        int status = 0;
+
+        if (run_if_named<tas_lock>(name, argc, argv, &status) ||
+            run_if_named<ttas_lock>(name, argc, argv, &status) ||
+            run_if_named<ticket_lock>(name, argc, argv, &status) ||
+            run_if_named<mcs_lock>(name, argc, argv, &status) ||
+            run_if_named<clh_lock>(name, argc, argv, &status) ||
+            run_if_named<cas_lock>(name, argc, argv, &status) ||
+            run_if_named<bcas_lock>(name, argc, argv, &status) ||
+            run_if_named<futex_lock>(name, argc, argv, &status) ||
+            run_if_named<cohort_lock>(name, argc, argv, &status))
+            {
+                return status;
+            }
+
+        std::cout << "ERROR: unknown lock " << name << "." << std::endl;
+        return -1;
+    }
@@ -3,128 +3,32 @@
 #include <math.h>
 #include <fstream>
 #include <chrono>
-using namespace std;
-
-bool check_row(const vector < vector <int> > &sudoku, int size, int row)
-{
-    bool output = true;
-    vector <bool> numbers(size,false);
-
-    for (int j = 0; j < size; j++)
-    {
-        int read_num = sudoku[row][j];
-        if (numbers[read_num - 1])
-        {
-            output = false;
-            break;
-        }
-        numbers[read_num - 1] = true;
-    }
-    
-    return output;
-}
-
-bool check_col(const vector < vector <int> > &sudoku, int size, int col)
-{
-    bool output = true;
-
-    vector <bool> numbers(size,false);
-
-    for (int i = 0; i < size; i++)
-    {
-        int read_num = sudoku[i][col];
-
-        if (numbers[read_num - 1])
-        {
-            output = false;
-            break;
-        }
-        
-        numbers[read_num - 1] = true;
-    }
-    
-    return output;
-}
-
-bool check_subgrid(const vector < vector <int> > &sudoku, int size, int row, int col)
-{
-    bool output = true;
-    int n = sqrt(size);
-
-    vector <bool> numbers(size,false);
 
-    for (int i = row; i < row + n; i++)
-    {
-        for (int j = col; j < col + n; j++)
-        {
-            int read_num = sudoku[i][j];
-
-            if (numbers[read_num - 1])
-            {
-                output = false;
-                break;
-            }
-            
-            numbers[read_num - 1] = true;
-        }
-    }
-    
-    return output;
-}
+#include "../common/sudoku_check.h"
+#include "../common/sudoku_fused.h"
+#include "../common/grid_io.h"
+using namespace std;
 
 int main()
     {
         auto start = chrono::high_resolution_clock::now();
 
-        int K,N,taskInc;
-        vector <vector <int>> Sudoku(N,vector<int>(N,0));
         bool valid = true;
 
-        ifstream inp("inp.txt");
-        inp >> K >> N >> taskInc;
+        sudoku_source inp;                        // inp.txt is mapped, text or binary grid format
+        sudoku_header header;
+        sudoku_grid Sudoku = {0, 1, 0, nullptr, false};
 
-        for (int i = 0; i < N; i++)
+        if (!sudoku_source_open(&inp, "inp.txt") || sudoku_source_next(&inp, 3, &header, &Sudoku) != 1)
             {
-                for (int j = 0; j < N; j++)
-                    {
-                        inp >> Sudoku[i][j];
-                    }
+                cout << "ERROR: Invalid input format." << endl;
+                return -1;
             }
-        
-        inp.close();
 
         ofstream out("outputSeq.txt");
 
-        for (int i = 0; i < N; i++)
-            {
-                if (!check_row(Sudoku,N,i))
-                    {
-                        valid = false;
-                        break;
-                    }
-                
-                else if (!check_col(Sudoku,N,i))
-                    {
-                        valid = false;
-                        break;
-                    }
-            }
-        
-        if (valid)
-            {
-                for (int i = 0; i < N; i += N)
-                    {
-                        for (int j = 0; j < N; j += N)
-                            {
-                                if(!check_subgrid(Sudoku,N,i,j))
-                                    {
-                                        valid = false;
-                                        break;
-                                    }
-                            }
-                    }
-            }
-        
+        valid = sudoku_check_fused(&Sudoku);      // rows, columns and subgrids in one pass
+
         out << "Sudoku is " << (valid?"valid.":"invalid.") << endl;
 
         auto end = chrono::high_resolution_clock::now();
@@ -132,6 +36,8 @@ int main()
         out << "Total time taken: " << time_taken.count() << " seconds." << endl;
 
         out.close();
+        sudoku_grid_free(&Sudoku);
+        sudoku_source_close(&inp);
 
         return 0;
     }
\ No newline at end of file
@@ -0,0 +1,189 @@
+// the Assignment2 validator with the tasks handed out through work-stealing deques. the program itself is
+// run_task_validator in common/task_validator.h, this file only has the dispatch policy.
+// ./a.out [--quiet] [--numa] [--csv file]
+
+#include <memory>
+
+#include "../common/task_validator.h"
+
+struct ws_deque
+    {
+        // Chase-Lev deque of task ranges. the owner takes ranges from the bottom, other threads steal from
+        // the top. all ranges are pushed before the threads start and nothing is pushed later, so the
+        // array never changes while it is being read.
+
+        alignas(CACHE_LINE) std::atomic<long> top;       // next range to steal (thieves' end)
+        alignas(CACHE_LINE) std::atomic<long> bottom;    // one past the owner's next range (owner's end)
+        std::vector<task_range> ranges;
+
+        ws_deque() : top(0), bottom(0) {}
+    };
+
+void ws_push(ws_deque *deque, task_range range)
+    {
+        // adds a range at the owner's end, only before the threads start
+
+        deque->ranges.push_back(range);
+        deque->bottom.store(deque->bottom.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+bool ws_pop(ws_deque *deque, task_range *range)
+    {
+        // owner: takes the range at the bottom. false if the deque is empty or a thief won the last range.
+
+        long b = deque->bottom.load(std::memory_order_relaxed) - 1;
+        deque->bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        long t = deque->top.load(std::memory_order_relaxed);
+
+        if (t > b)
+            {
+                // empty
+
+                deque->bottom.store(b + 1, std::memory_order_relaxed);
+                return false;
+            }
+
+        *range = deque->ranges[b];
+
+        if (t == b)
+            {
+                // the last range, thieves may be after it too
+
+                bool won = deque->top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+                deque->bottom.store(b + 1, std::memory_order_relaxed);
+                return won;
+            }
+
+        return true;
+    }
+
+int ws_steal(ws_deque *deque, task_range *range)
+    {
+        // thief: takes the range at the top. returns 1 on success, 0 if the deque is empty and -1 if
+        // another thread got there first (worth retrying).
+
+        long t = deque->top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        long b = deque->bottom.load(std::memory_order_acquire);
+
+        if (t >= b)
+            {
+                return 0;
+            }
+
+        *range = deque->ranges[t];
+
+        if (!deque->top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            {
+                return -1;
+            }
+
+        return 1;
+    }
+
+struct steal_dispatch : task_policy
+    {
+        // the 3*N tasks are split into K contiguous blocks, one per deque, cut into ranges of taskInc
+        // tasks. a thread works through its own deque first, then steals from random victims. the checks
+        // never create new work, so once every deque was found empty there is nothing left anywhere.
+
+        static constexpr const char *name = "steal";
+        static constexpr const char *output = "outputSteal.txt";
+        static constexpr const char *claim_what = "get a task range";
+
+        struct alignas(CACHE_LINE) thief
+            {
+                uint32_t seed;          // xorshift state for picking victims
+                int ranges = 0;         // ranges the thread got
+                int steals = 0;         // of those, taken from other threads' deques
+            };
+
+        int no_of_deques;
+        std::unique_ptr<ws_deque[]> deques;         // deques[thread] belongs to thread
+        std::unique_ptr<thief[]> thieves;
+
+        steal_dispatch(int threads, int size, int task_inc) : no_of_deques(threads), deques(new ws_deque[threads]), thieves(new thief[threads])
+            {
+                // the ranges are pushed back to front so the owner works through its block in order while
+                // thieves take from the far end
+
+                int step = std::max(task_inc, 1);
+
+                for (int i = 0; i < threads; i++)
+                    {
+                        int block_first = (int)((long)3*size * i / threads);
+                        int block_last = (int)((long)3*size * (i + 1) / threads);
+                        int no_of_ranges = (block_last - block_first + step - 1) / step;
+
+                        for (int r = no_of_ranges - 1; r >= 0; r--)
+                            {
+                                int first = block_first + r * step;
+                                ws_push(&deques[i], {first, std::min(first + step, block_last)});
+                            }
+
+                        thieves[i].seed = 2654435761u * (i + 1);
+                    }
+            }
+
+        bool next(int thread, task_range *range, trace_buffer *trace)
+            {
+                ws_deque *own = &deques[thread];
+                thief *me = &thieves[thread];
+
+                int victim = -1;                    // -1 => the range came from our own deque
+                bool found = ws_pop(own, range);
+
+                for (int tries = 0; !found && tries < 2 * no_of_deques; tries++)
+                    {
+                        // a few random victims, so that thieves spread out over the deques
+
+                        me->seed ^= me->seed << 13;
+                        me->seed ^= me->seed >> 17;
+                        me->seed ^= me->seed << 5;
+                        victim = me->seed % no_of_deques;
+
+                        found = (&deques[victim] != own && ws_steal(&deques[victim], range) == 1);
+                    }
+
+                for (int i = 0; !found && i < no_of_deques; i++)
+                    {
+                        // then one sweep over all of them before giving up
+
+                        int stolen;
+
+                        while ((stolen = ws_steal(&deques[i], range)) < 0) {}
+
+                        found = (stolen == 1);
+                        victim = i;
+                    }
+
+                if (!found)
+                    {
+                        return false;
+                    }
+
+                me->ranges++;
+                me->steals += (victim >= 0);
+                dispatch_log(trace, thread, (victim < 0) ? TRACE_TAKE : TRACE_STEAL, range->first + 1, range->last, victim + 1);
+                return true;
+            }
+
+        void report(std::ostream &out)
+            {
+                int ranges = 0, steals = 0;
+
+                for (int i = 0; i < no_of_deques; i++)
+                    {
+                        ranges += thieves[i].ranges;
+                        steals += thieves[i].steals;
+                    }
+
+                out << "Task ranges stolen from other threads: " << steals << " of " << ranges << std::endl;
+            }
+    };
+
+int main(int argc, char **argv)
+    {
+        return run_task_validator<steal_dispatch>(argc, argv);
+    }
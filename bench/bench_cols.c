@@ -0,0 +1,145 @@
+// benchmark of the column phase: the old one column at a time strided kernel against the row by row
+// column engine of common/sudoku_cols.h, for every engine this cpu can run.
+//
+// build: gcc -O2 -o bench_cols bench/bench_cols.c
+// usage: ./bench_cols [N ...]          (default sizes 9 16 25 36 49 64 81 256 1024 2048)
+//
+// every engine's verdicts are compared with the strided kernel before it is timed. each row names the
+// engine that really ran (see col_engine_used), and an engine that would fall back to one already shown
+// for that N is skipped rather than timed again under its own name.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <time.h>
+
+#include "../common/sudoku_cols.h"
+
+static double now_us(void)
+    {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+    }
+
+static void fill_grid(sudoku_grid *grid)
+    {
+        // a valid sudoku, then a few swaps inside rows so that some columns turn invalid
+
+        int size = grid->size;
+        int n = sudoku_box_size(size);
+
+        for (int r = 0; r < size; r++)
+            {
+                for (int c = 0; c < size; c++)
+                    {
+                        sudoku_grid_set(grid, r, c, (n * (r % n) + r / n + c) % size + 1);
+                    }
+            }
+
+        for (int k = 0; k < size / 8; k++)
+            {
+                int r = rand() % size, c1 = rand() % size, c2 = rand() % size;
+                int v1 = sudoku_grid_get(grid, r, c1);
+
+                sudoku_grid_set(grid, r, c1, sudoku_grid_get(grid, r, c2));
+                sudoku_grid_set(grid, r, c2, v1);
+            }
+    }
+
+static double time_strided(const sudoku_grid *grid, bool *col_valid, int reps)
+    {
+        double start = now_us();
+
+        for (int rep = 0; rep < reps; rep++)
+            {
+                for (int c = 0; c < grid->size; c++)
+                    {
+                        col_valid[c] = sudoku_check_col(grid, c);
+                    }
+            }
+
+        return (now_us() - start) / reps;
+    }
+
+static double time_engine(col_engine engine, const sudoku_grid *grid, bool *col_valid, int reps)
+    {
+        double start = now_us();
+
+        for (int rep = 0; rep < reps; rep++)
+            {
+                sudoku_check_cols_step_with(engine, grid, 0, grid->size, 1, col_valid);
+            }
+
+        return (now_us() - start) / reps;
+    }
+
+int main(int argc, char **argv)
+    {
+        int default_sizes[] = {9, 16, 25, 36, 49, 64, 81, 256, 1024, 2048};
+        int count = sizeof(default_sizes) / sizeof(default_sizes[0]);
+
+        col_engine best = col_engine_detect();
+        col_engine engines[] = {COL_ENGINE_SCALAR, COL_ENGINE_SSE42, COL_ENGINE_AVX2, COL_ENGINE_AVX512};
+        int no_of_engines = sizeof(engines) / sizeof(engines[0]);
+
+        printf("detected engine: %s\n", col_engine_name(best));
+        printf("%6s %10s %14s %14s %9s\n", "N", "engine", "strided(us)", "engine(us)", "speedup");
+
+        for (int a = 0; a < (argc > 1 ? argc - 1 : count); a++)
+            {
+                int size = (argc > 1) ? atoi(argv[a + 1]) : default_sizes[a];
+
+                sudoku_grid grid;
+
+                if (!sudoku_grid_init(&grid, size))
+                    {
+                        printf("ERROR: cannot allocate a %d x %d grid.\n", size, size);
+                        continue;
+                    }
+
+                fill_grid(&grid);
+
+                bool *expected = (bool *)malloc(size * sizeof(bool));
+                bool *got = (bool *)malloc(size * sizeof(bool));
+
+                // aim for roughly 64M cells per measurement
+                long long cells = (long long)size * size;
+                int reps = (int)(64000000LL / cells);
+                reps = (reps < 3) ? 3 : reps;
+
+                double strided = time_strided(&grid, expected, reps);
+                unsigned shown = 0;
+
+                for (int e = 0; e < no_of_engines; e++)
+                    {
+                        col_engine used = col_engine_used(engines[e], &grid, 1);
+
+                        if (engines[e] > best || (shown & (1u << used)))
+                            {
+                                continue;
+                            }
+
+                        shown |= 1u << used;
+                        time_engine(engines[e], &grid, got, 1);
+
+                        for (int c = 0; c < size; c++)
+                            {
+                                if (got[c] != expected[c])
+                                    {
+                                        printf("ERROR: %s engine disagrees on column %d of N = %d.\n", col_engine_name(used), c + 1, size);
+                                        return 1;
+                                    }
+                            }
+
+                        double engine_time = time_engine(engines[e], &grid, got, reps);
+                        printf("%6d %10s %14.3f %14.3f %8.2fx\n", size, col_engine_name(used), strided, engine_time, strided / engine_time);
+                    }
+
+                free(expected);
+                free(got);
+                sudoku_grid_free(&grid);
+            }
+
+        return 0;
+    }
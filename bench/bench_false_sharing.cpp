@@ -0,0 +1,327 @@
+// false sharing microbenchmark for the Assignment2 locks: every thread repeatedly takes the lock, bumps
+// the shared counter, releases the lock, reads the valid / cancel flags and counts the acquisition in its
+// own slot, the way the validators do per claim. each lock runs twice, once with the state around it
+// packed next to each other (how plain globals and a vector of per-thread structs end up in memory) and
+// once with every independently written piece on a cache line of its own (common/cache_line.h).
+//
+// the locks are the policies the validators use (common/lock_policies.h), which keep their own words on
+// lines of their own, so the layout only moves the counter, the flags and the per-thread counts. it is a
+// template parameter, so both layouts run the same inlined code.
+//
+// build: g++ -std=c++17 -O2 -o bench_false_sharing bench/bench_false_sharing.cpp -lpthread
+// usage: ./bench_false_sharing [-t threads] [-n acquisitions] [-w work] [-r repeats] [--spin steps]
+//                              [--budget handoffs] [--cohorts count] [lock ...]
+//
+//     -t   threads, default the number of online cpus
+//     -n   acquisitions per thread, default 200000
+//     -w   steps of private work between two acquisitions, default 50
+//     -r   runs per layout, the median is reported, default 5
+//     --spin, --budget, --cohorts
+//          the options of the futex and cohort locks, as in bench_locks
+//     lock any of tas, ttas, ticket, mcs, clh, cas, bcas, futex, cohort and faa (no lock, the counter is
+//          bumped with fetch_add), default all of them
+//
+// the counter is compared with the per-thread counts after every run, so a broken lock shows up as an
+// error rather than as a fast time.
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <type_traits>
+#include <vector>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "../common/cache_line.h"
+#include "../common/lock_policies.h"
+
+#define MAX_RUNS 64     // most runs kept per layout for the median
+
+struct no_lock : lock_policy
+    {
+        // faa: the counter is bumped with fetch_add, lock and unlock are never called
+
+        static constexpr const char *name = "faa";
+
+        explicit no_lock(int /* threads */) {}
+
+        void lock(int /* thread */) {}
+        void unlock(int /* thread */) {}
+    };
+
+template <class T, bool Padded>
+struct slot
+    {
+        // packed: T where the compiler puts it next to its neighbours
+
+        T value{};
+    };
+
+template <class T>
+struct alignas(CACHE_LINE) slot<T, true>
+    {
+        // padded: T on a line of its own, in arrays as well
+
+        T value{};
+    };
+
+template <bool Padded>
+struct shared_state
+    {
+        // the state around the lock that the validators touch per claim
+
+        slot<std::atomic<int>, Padded> counter;         // written by every lock holder
+        slot<std::atomic<bool>, Padded> valid;          // read by every thread after every claim
+        slot<std::atomic<bool>, Padded> cancel;
+        std::unique_ptr<slot<std::atomic<long>, Padded>[]> acquired;   // acquisitions of each thread, written by that thread
+
+        explicit shared_state(int threads) : acquired(new slot<std::atomic<long>, Padded>[threads])
+            {
+                valid.value.store(true);
+            }
+    };
+
+template <class Lock, bool Padded>
+struct worker
+    {
+        Lock *lock;
+        shared_state<Padded> *shared;
+        pthread_barrier_t *start;
+        int id;
+        long iterations;
+        int work;
+        double began;       // when this thread left the barrier and when it finished, in microseconds
+        double ended;
+    };
+
+static double now_us(void)
+    {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+    }
+
+template <class Lock, bool Padded>
+static void *run_worker(void *param)
+    {
+        worker<Lock, Padded> *w = (worker<Lock, Padded> *)param;
+        shared_state<Padded> *s = w->shared;
+        std::atomic<long> &acquired = s->acquired[w->id].value;
+        volatile unsigned sink = 0;
+
+        pthread_barrier_wait(w->start);
+        w->began = now_us();
+
+        for (long i = 0; i < w->iterations; i++)
+            {
+                if (std::is_same<Lock, no_lock>::value)
+                    {
+                        s->counter.value.fetch_add(1, std::memory_order_relaxed);
+                    }
+
+                else
+                    {
+                        w->lock->lock(w->id);
+
+                        int c = s->counter.value.load(std::memory_order_relaxed);
+                        s->counter.value.store(c + 1, std::memory_order_relaxed);
+
+                        w->lock->unlock(w->id);
+                    }
+
+                // the checks of the claimed tasks: private work, then the flags every task looks at
+
+                for (int k = 0; k < w->work; k++)
+                    {
+                        sink += k;
+                    }
+
+                if (s->cancel.value.load(std::memory_order_relaxed) || !s->valid.value.load(std::memory_order_relaxed))
+                    {
+                        break;
+                    }
+
+                acquired.store(acquired.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            }
+
+        w->ended = now_us();
+        return NULL;
+    }
+
+template <class Lock, bool Padded>
+static double run_once(Lock *lock, int threads, long iterations, int work)
+    {
+        // acquisitions per second of one run, or -1 if the lock lost updates
+
+        shared_state<Padded> shared(threads);
+        std::vector<pthread_t> ids(threads);
+        std::vector<worker<Lock, Padded>> workers(threads);
+        pthread_barrier_t start;
+
+        pthread_barrier_init(&start, NULL, threads + 1);
+
+        for (int i = 0; i < threads; i++)
+            {
+                workers[i] = {lock, &shared, &start, i, iterations, work, 0, 0};
+
+                pthread_attr_t attr;
+                pthread_attr_init(&attr);
+                lock->place(i, &attr);
+                pthread_create(&ids[i], &attr, run_worker<Lock, Padded>, &workers[i]);
+                pthread_attr_destroy(&attr);
+            }
+
+        pthread_barrier_wait(&start);
+
+        for (int i = 0; i < threads; i++)
+            {
+                pthread_join(ids[i], NULL);
+            }
+
+        // timed by the workers themselves, from the first one leaving the barrier to the last one done,
+        // since this thread may only get the cpu back after they have all finished
+
+        double begin = workers[0].began, end = workers[0].ended;
+        long total = 0;
+
+        for (int i = 0; i < threads; i++)
+            {
+                begin = std::min(begin, workers[i].began);
+                end = std::max(end, workers[i].ended);
+                total += shared.acquired[i].value.load();
+            }
+
+        pthread_barrier_destroy(&start);
+
+        return (total == shared.counter.value.load()) ? total * 1e6 / (end - begin) : -1;
+    }
+
+template <class Lock, bool Padded>
+static double median_rate(Lock *lock, int threads, long iterations, int work, int repeats)
+    {
+        double rates[MAX_RUNS];
+
+        for (int r = 0; r < repeats; r++)
+            {
+                rates[r] = run_once<Lock, Padded>(lock, threads, iterations, work);
+
+                if (rates[r] < 0)
+                    {
+                        return -1;
+                    }
+            }
+
+        std::sort(rates, rates + repeats);
+        return rates[repeats / 2];
+    }
+
+template <class Lock>
+static bool run_lock(int threads, long iterations, int work, int repeats, int argc, char **argv)
+    {
+        // runs one lock in both layouts and prints the two medians, false if the lock lost updates
+
+        Lock lock(threads);
+        lock.configure(argc, argv);
+
+        double packed = median_rate<Lock, false>(&lock, threads, iterations, work, repeats);
+        double padded = median_rate<Lock, true>(&lock, threads, iterations, work, repeats);
+
+        if (packed < 0 || padded < 0)
+            {
+                printf("ERROR: the %s lock lost counter updates.\n", Lock::name);
+                return false;
+            }
+
+        printf("%8s %16.0f %16.0f %8.2fx\n", Lock::name, packed, padded, padded / packed);
+        return true;
+    }
+
+template <class Lock>
+static bool run_if_selected(const std::vector<const char *> &selected, int threads, long iterations, int work, int repeats, int argc, char **argv)
+    {
+        bool wanted = selected.empty();
+
+        for (const char *name : selected)
+            {
+                wanted = wanted || strcmp(name, Lock::name) == 0;
+            }
+
+        return !wanted || run_lock<Lock>(threads, iterations, work, repeats, argc, argv);
+    }
+
+int main(int argc, char **argv)
+    {
+        int threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+        long iterations = 200000;
+        int work = 50;
+        int repeats = 5;
+        std::vector<const char *> selected;
+        const char *locks[] = {"tas", "ttas", "ticket", "mcs", "clh", "cas", "bcas", "futex", "cohort", "faa"};
+
+        for (int i = 1; i < argc; i++)
+            {
+                bool has_value = (i + 1 < argc);
+
+                if (strcmp(argv[i], "-t") == 0 && has_value)
+                    {
+                        threads = atoi(argv[++i]);
+                    }
+
+                else if (strcmp(argv[i], "-n") == 0 && has_value)
+                    {
+                        iterations = atol(argv[++i]);
+                    }
+
+                else if (strcmp(argv[i], "-w") == 0 && has_value)
+                    {
+                        work = atoi(argv[++i]);
+                    }
+
+                else if (strcmp(argv[i], "-r") == 0 && has_value)
+                    {
+                        repeats = atoi(argv[++i]);
+                    }
+
+                else if ((strcmp(argv[i], "--spin") == 0 || strcmp(argv[i], "--budget") == 0 || strcmp(argv[i], "--cohorts") == 0) && has_value)
+                    {
+                        i++;        // read by the lock itself
+                    }
+
+                else if (std::find_if(std::begin(locks), std::end(locks), [&](const char *l) { return strcmp(l, argv[i]) == 0; }) != std::end(locks))
+                    {
+                        selected.push_back(argv[i]);
+                    }
+
+                else
+                    {
+                        printf("usage: %s [-t threads] [-n acquisitions] [-w work] [-r repeats] [--spin steps] [--budget handoffs] [--cohorts count] [tas|ttas|ticket|mcs|clh|cas|bcas|futex|cohort|faa ...]\n", argv[0]);
+                        return 1;
+                    }
+            }
+
+        if (threads < 1 || iterations < 1 || work < 0 || repeats < 1 || repeats > MAX_RUNS)
+            {
+                printf("ERROR: -t, -n and -r need positive values (at most %d runs), -w a non-negative one.\n", MAX_RUNS);
+                return 1;
+            }
+
+        printf("threads %d, %ld acquisitions each, work %d, median of %d runs\n", threads, iterations, work, repeats);
+        printf("%8s %16s %16s %9s\n", "lock", "packed(acq/s)", "padded(acq/s)", "speedup");
+
+        bool ok = run_if_selected<tas_lock>(selected, threads, iterations, work, repeats, argc, argv) &&
+                  run_if_selected<ttas_lock>(selected, threads, iterations, work, repeats, argc, argv) &&
+                  run_if_selected<ticket_lock>(selected, threads, iterations, work, repeats, argc, argv) &&
+                  run_if_selected<mcs_lock>(selected, threads, iterations, work, repeats, argc, argv) &&
+                  run_if_selected<clh_lock>(selected, threads, iterations, work, repeats, argc, argv) &&
+                  run_if_selected<cas_lock>(selected, threads, iterations, work, repeats, argc, argv) &&
+                  run_if_selected<bcas_lock>(selected, threads, iterations, work, repeats, argc, argv) &&
+                  run_if_selected<futex_lock>(selected, threads, iterations, work, repeats, argc, argv) &&
+                  run_if_selected<cohort_lock>(selected, threads, iterations, work, repeats, argc, argv) &&
+                  run_if_selected<no_lock>(selected, threads, iterations, work, repeats, argc, argv);
+
+        return ok ? 0 : 1;
+    }
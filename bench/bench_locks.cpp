@@ -0,0 +1,348 @@
+// lock microbenchmark for the Assignment2 locks, without the sudoku around them: every thread takes the
+// lock, spends a fixed number of steps inside, releases it and spends another fixed number outside,
+// until the run time is up. the locks are the policies the validators use (common/lock_policies.h), so
+// what is measured here is exactly the code the validators run.
+//
+// build: g++ -std=c++17 -O2 -o bench_locks bench/bench_locks.cpp -lpthread
+// usage: ./bench_locks [-t threads] [-c steps] [-w steps] [-d ms] [-r repeats] [--spin steps]
+//                      [--budget handoffs] [--cohorts count] [lock ...]
+//
+//     -t      threads, default the number of online cpus
+//     -c      steps of work inside the critical section, default 0
+//     -w      steps of work between two acquisitions, default 50
+//     -d      run time per lock in milliseconds, default 500
+//     -r      runs per lock, the one with the median throughput is reported, default 1
+//     --spin  spin limit of the futex lock, calibrated if not given
+//     --budget, --cohorts
+//             handoffs inside a node and number of cohorts of the cohort lock
+//     lock    any of tas, ttas, ticket, mcs, clh, cas, bcas, futex and cohort, default all of them
+//
+// per lock it prints
+//     acq/s     acquisitions per second of all the threads together
+//     handoff   p50 / p90 / p99 / max of the handoff latency in nanoseconds: the time from one thread's
+//               release to the next thread's acquire, counted only when that next thread was already
+//               waiting at the release, so an idle lock is not mistaken for a slow one
+//     fairness  Jain's index of the per-thread acquisition counts, (sum x)^2 / (n * sum x^2): 1 when all
+//               threads got the lock equally often, 1/n when one thread got it every time
+//
+// a counter bumped inside the critical section is compared with the per-thread counts after every run,
+// so a broken lock shows up as an error rather than as a fast time.
+
+#include <algorithm>
+#include <vector>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "../common/cache_line.h"
+#include "../common/lock_policies.h"
+
+#define MAX_RUNS 64         // most runs kept per lock for the median
+
+typedef struct
+    {
+        int threads;
+        int cs_work;
+        int work;
+        long duration_ms;
+        int repeats;
+
+    } bench_options;
+
+typedef struct
+    {
+        double rate;            // acquisitions per second, -1 if the lock lost updates
+        double fairness;
+        long long p50, p90, p99, max;
+        long handoffs;
+
+    } bench_result;
+
+struct alignas(CACHE_LINE) shared_state
+    {
+        // written only by the lock holder
+
+        long counter = 0;
+        int last_holder = -1;
+        long long last_release = 0;
+    };
+
+struct alignas(CACHE_LINE) worker
+    {
+        int thread;
+        long acquisitions = 0;
+        long long began = 0, ended = 0;
+        std::vector<long long> handoffs;        // nanoseconds
+    };
+
+template <class Lock>
+struct bench_run
+    {
+        Lock *lock;
+        shared_state *shared;
+        const bench_options *options;
+        pthread_barrier_t *start;
+        long long deadline;
+        worker *w;
+    };
+
+static long long now_ns(void)
+    {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+    }
+
+template <class Lock>
+static void *run_worker(void *param)
+    {
+        bench_run<Lock> *run = (bench_run<Lock> *)param;
+        worker *w = run->w;
+        shared_state *s = run->shared;
+        volatile unsigned sink = 0;
+
+        pthread_barrier_wait(run->start);
+        w->began = now_ns();
+
+        while (true)
+            {
+                long long requested = now_ns();
+
+                if (requested >= run->deadline)
+                    {
+                        break;
+                    }
+
+                run->lock->lock(w->thread);
+
+                long long acquired = now_ns();
+
+                if (s->last_holder != w->thread && s->last_release >= requested)
+                    {
+                        // we were queued when the previous holder let go
+
+                        w->handoffs.push_back(acquired - s->last_release);
+                    }
+
+                for (int k = 0; k < run->options->cs_work; k++)
+                    {
+                        sink += k;
+                    }
+
+                s->counter++;
+                s->last_holder = w->thread;
+                s->last_release = now_ns();
+
+                run->lock->unlock(w->thread);
+
+                w->acquisitions++;
+
+                for (int k = 0; k < run->options->work; k++)
+                    {
+                        sink += k;
+                    }
+            }
+
+        w->ended = now_ns();
+        return NULL;
+    }
+
+static long long percentile(const std::vector<long long> &sorted, double p)
+    {
+        if (sorted.empty())
+            {
+                return 0;
+            }
+
+        size_t rank = (size_t)(p * (sorted.size() - 1) + 0.5);
+        return sorted[rank];
+    }
+
+template <class Lock>
+static bench_result run_once(Lock *lock, const bench_options *options)
+    {
+        int threads = options->threads;
+        shared_state shared;
+        std::vector<pthread_t> ids(threads);
+        std::vector<worker> workers(threads);
+        std::vector<bench_run<Lock>> runs(threads);
+        pthread_barrier_t start;
+
+        pthread_barrier_init(&start, NULL, threads + 1);
+
+        // the deadline counts from before the threads exist, so a slow start shortens the run rather
+        // than stretching it
+
+        long long deadline = now_ns() + options->duration_ms * 1000000LL;
+
+        for (int i = 0; i < threads; i++)
+            {
+                workers[i].thread = i;
+                workers[i].handoffs.reserve(1 << 16);
+                runs[i] = {lock, &shared, options, &start, deadline, &workers[i]};
+
+                pthread_attr_t attr;
+                pthread_attr_init(&attr);
+                lock->place(i, &attr);
+                pthread_create(&ids[i], &attr, run_worker<Lock>, &runs[i]);
+                pthread_attr_destroy(&attr);
+            }
+
+        pthread_barrier_wait(&start);
+
+        for (int i = 0; i < threads; i++)
+            {
+                pthread_join(ids[i], NULL);
+            }
+
+        // timed by the workers themselves, from the first one leaving the barrier to the last one done
+
+        long long begin = workers[0].began, end = workers[0].ended;
+        long total = 0;
+        double sum_squares = 0;
+        std::vector<long long> handoffs;
+
+        for (int i = 0; i < threads; i++)
+            {
+                begin = std::min(begin, workers[i].began);
+                end = std::max(end, workers[i].ended);
+                total += workers[i].acquisitions;
+                sum_squares += (double)workers[i].acquisitions * workers[i].acquisitions;
+                handoffs.insert(handoffs.end(), workers[i].handoffs.begin(), workers[i].handoffs.end());
+            }
+
+        std::sort(handoffs.begin(), handoffs.end());
+        pthread_barrier_destroy(&start);
+
+        bench_result result;
+
+        result.rate = (total == shared.counter && end > begin) ? total * 1e9 / (end - begin) : -1;
+        result.fairness = (sum_squares > 0) ? (double)total * total / (threads * sum_squares) : 0;
+        result.p50 = percentile(handoffs, 0.50);
+        result.p90 = percentile(handoffs, 0.90);
+        result.p99 = percentile(handoffs, 0.99);
+        result.max = handoffs.empty() ? 0 : handoffs.back();
+        result.handoffs = (long)handoffs.size();
+
+        return result;
+    }
+
+template <class Lock>
+static bool run_lock(const bench_options *options, int argc, char **argv)
+    {
+        // runs one lock repeats times and prints the run with the median throughput, false if the lock
+        // lost updates
+
+        Lock lock(options->threads);
+        lock.configure(argc, argv);
+
+        bench_result results[MAX_RUNS];
+
+        for (int r = 0; r < options->repeats; r++)
+            {
+                results[r] = run_once(&lock, options);
+
+                if (results[r].rate < 0)
+                    {
+                        printf("ERROR: the %s lock lost counter updates.\n", Lock::name);
+                        return false;
+                    }
+            }
+
+        std::sort(results, results + options->repeats, [](const bench_result &a, const bench_result &b) { return a.rate < b.rate; });
+
+        const bench_result &m = results[options->repeats / 2];
+
+        printf("%8s %14.0f %10ld %9lld %9lld %9lld %10lld %9.3f\n", Lock::name, m.rate, m.handoffs, m.p50, m.p90, m.p99, m.max, m.fairness);
+        return true;
+    }
+
+template <class Lock>
+static bool run_if_selected(const std::vector<const char *> &selected, const bench_options *options, int argc, char **argv)
+    {
+        bool wanted = selected.empty();
+
+        for (const char *name : selected)
+            {
+                wanted = wanted || strcmp(name, Lock::name) == 0;
+            }
+
+        return !wanted || run_lock<Lock>(options, argc, argv);
+    }
+
+int main(int argc, char **argv)
+    {
+        bench_options options = {(int)sysconf(_SC_NPROCESSORS_ONLN), 0, 50, 500, 1};
+        std::vector<const char *> selected;
+        const char *locks[] = {"tas", "ttas", "ticket", "mcs", "clh", "cas", "bcas", "futex", "cohort"};
+
+        for (int i = 1; i < argc; i++)
+            {
+                bool has_value = (i + 1 < argc);
+
+                if (strcmp(argv[i], "-t") == 0 && has_value)
+                    {
+                        options.threads = atoi(argv[++i]);
+                    }
+
+                else if (strcmp(argv[i], "-c") == 0 && has_value)
+                    {
+                        options.cs_work = atoi(argv[++i]);
+                    }
+
+                else if (strcmp(argv[i], "-w") == 0 && has_value)
+                    {
+                        options.work = atoi(argv[++i]);
+                    }
+
+                else if (strcmp(argv[i], "-d") == 0 && has_value)
+                    {
+                        options.duration_ms = atol(argv[++i]);
+                    }
+
+                else if (strcmp(argv[i], "-r") == 0 && has_value)
+                    {
+                        options.repeats = atoi(argv[++i]);
+                    }
+
+                else if ((strcmp(argv[i], "--spin") == 0 || strcmp(argv[i], "--budget") == 0 || strcmp(argv[i], "--cohorts") == 0) && has_value)
+                    {
+                        i++;        // read by the lock itself
+                    }
+
+                else if (std::find_if(std::begin(locks), std::end(locks), [&](const char *l) { return strcmp(l, argv[i]) == 0; }) != std::end(locks))
+                    {
+                        selected.push_back(argv[i]);
+                    }
+
+                else
+                    {
+                        printf("usage: %s [-t threads] [-c steps] [-w steps] [-d ms] [-r repeats] [--spin steps] [--budget handoffs] [--cohorts count] [tas|ttas|ticket|mcs|clh|cas|bcas|futex|cohort ...]\n", argv[0]);
+                        return 1;
+                    }
+            }
+
+        if (options.threads < 1 || options.cs_work < 0 || options.work < 0 || options.duration_ms < 1 || options.repeats < 1 || options.repeats > MAX_RUNS)
+            {
+                printf("ERROR: -t, -d and -r need positive values (at most %d runs), -c and -w non-negative ones.\n", MAX_RUNS);
+                return 1;
+            }
+
+        printf("threads %d, cs work %d, work %d, %ld ms per run, median of %d runs\n", options.threads, options.cs_work, options.work, options.duration_ms, options.repeats);
+        printf("%8s %14s %10s %9s %9s %9s %10s %9s\n", "lock", "acq/s", "handoffs", "p50(ns)", "p90(ns)", "p99(ns)", "max(ns)", "fairness");
+
+        bool ok = run_if_selected<tas_lock>(selected, &options, argc, argv) &&
+                  run_if_selected<ttas_lock>(selected, &options, argc, argv) &&
+                  run_if_selected<ticket_lock>(selected, &options, argc, argv) &&
+                  run_if_selected<mcs_lock>(selected, &options, argc, argv) &&
+                  run_if_selected<clh_lock>(selected, &options, argc, argv) &&
+                  run_if_selected<cas_lock>(selected, &options, argc, argv) &&
+                  run_if_selected<bcas_lock>(selected, &options, argc, argv) &&
+                  run_if_selected<futex_lock>(selected, &options, argc, argv) &&
+                  run_if_selected<cohort_lock>(selected, &options, argc, argv);
+
+        return ok ? 0 : 1;
+    }
@@ -0,0 +1,584 @@
+// benchmark driver for the validators: runs the Assignment1 program (sequential, chunk, mixed and
+// fused methods) and the Assignment2 dispatch programs (TAS, TTAS, ticket, MCS, CLH, NUMA cohort,
+// spin-then-park futex, CAS, bounded CAS, lock-free fetch_add, guided chunks and work stealing) over
+// every combination of K, N and taskInc, with warmup runs and repeated samples, and prints median / p90 /
+// p99 per strategy.
+//
+// build the programs into one directory first:
+//     gcc -O2 -o bin/assgn1 Assignment1/Assgn1Src-CO23BTECH11021.c -lpthread -lm
+//     g++ -std=c++17 -O2 -o bin/tas Assignment2/Assgn2Src-CO23BTECH11021_TAS.cpp -lpthread
+//     g++ -std=c++17 -O2 -o bin/ttas Assignment2/Assgn2Src-CO23BTECH11021_TTAS.cpp -lpthread
+//     g++ -std=c++17 -O2 -o bin/ticket Assignment2/Assgn2Src-CO23BTECH11021_TICKET.cpp -lpthread
+//     g++ -std=c++17 -O2 -o bin/mcs Assignment2/Assgn2Src-CO23BTECH11021_MCS.cpp -lpthread
+//     g++ -std=c++17 -O2 -o bin/clh Assignment2/Assgn2Src-CO23BTECH11021_CLH.cpp -lpthread
+//     g++ -std=c++17 -O2 -o bin/cohort Assignment2/Assgn2Src-CO23BTECH11021_COHORT.cpp -lpthread
+//     g++ -std=c++17 -O2 -o bin/futex Assignment2/Assgn2Src-CO23BTECH11021_FUTEX.cpp -lpthread
+//     g++ -std=c++17 -O2 -o bin/faa Assignment2/Assgn2Src-CO23BTECH11021_FAA.cpp -lpthread
+//     g++ -std=c++17 -O2 -o bin/guided Assignment2/Assgn2Src-CO23BTECH11021_GUIDED.cpp -lpthread
+//     g++ -std=c++17 -O2 -o bin/steal Assignment2/Assgn2Src-CO23BTECH11021_STEAL.cpp -lpthread
+//     g++ -std=c++17 -O2 -o bin/cas Assignment2/Assgn2Src-CO23BTECH11021_CAS.cpp -lpthread
+//     g++ -std=c++17 -O2 -o bin/bcas Assignment2/Assgn2Src-CO23BTECH11021_BCAS.cpp -lpthread
+//     gcc -O2 -o bench_sweep bench/bench_sweep.c
+//
+// usage: ./bench_sweep [-b bin] [-k 3,6,12] [-n 9,16,36,81] [-i 1,4,16] [-s strategies] [-w warmup]
+//                      [-r samples] [--json] [--quiet] [--invalid]
+//
+//     -s        comma separated subset of sequential,chunk,mixed,fused,tas,ttas,ticket,mcs,clh,cohort,futex,cas,bcas,faa,guided,steal
+//     --quiet   passes --quiet to the programs, so the tasks do not log messages at all
+//     --invalid swaps two cells in the middle row, so the grids are rejected
+//
+// three times are kept per sample, all in microseconds:
+//     validate  validation only, as reported by the program (no input, no message output)
+//     total     what the program reports as its total for that strategy (includes writing the messages;
+//               for the Assignment2 programs also reading the input)
+//     process   wall clock of the whole process, measured here. one Assignment1 run covers all four of
+//               its methods, so they share this number.
+// and for the Assignment2 programs the rate at which task ranges were claimed from the shared counter
+// (claims per second of validation time, 0 for Assignment1). scalability over K is this rate, or the
+// validate time, read down the rows of one strategy.
+// the Assignment1 methods do not use taskInc and are only run once per K and N (task_inc 0 in the output).
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#define MAX_VALUES 64   // longest list accepted for -k, -n and -i
+
+typedef struct
+    {
+        const char *name;       // strategy name on the command line and in the output
+        const char *program;    // binary in the -b directory
+        const char *output;     // file the program writes
+        const char *section;    // Assignment1: header of the method's section in output.txt, else NULL
+
+    } strategy;
+
+static const strategy strategies[] =
+    {
+        {"sequential", "assgn1", "output.txt", "Sequential method"},
+        {"chunk", "assgn1", "output.txt", "Chunk method"},
+        {"mixed", "assgn1", "output.txt", "Mixed method"},
+        {"fused", "assgn1", "output.txt", "Fused method"},
+        {"tas", "tas", "outputTas.txt", NULL},
+        {"ttas", "ttas", "outputTtas.txt", NULL},
+        {"ticket", "ticket", "outputTicket.txt", NULL},
+        {"mcs", "mcs", "outputMcs.txt", NULL},
+        {"clh", "clh", "outputClh.txt", NULL},
+        {"cohort", "cohort", "outputCohort.txt", NULL},
+        {"futex", "futex", "outputFutex.txt", NULL},
+        {"faa", "faa", "outputFaa.txt", NULL},
+        {"guided", "guided", "outputGuided.txt", NULL},
+        {"steal", "steal", "outputSteal.txt", NULL},
+        {"cas", "cas", "outputCas.txt", NULL},
+        {"bcas", "bcas", "outputBoundedcas.txt", NULL},
+    };
+
+#define NO_OF_STRATEGIES (int)(sizeof(strategies) / sizeof(strategies[0]))
+
+typedef struct
+    {
+        double *validate;
+        double *total;
+        double *process;
+        double *claims;
+        int count;
+
+    } samples;
+
+static double now_us(void)
+    {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+    }
+
+static int parse_list(const char *text, int *values)
+    {
+        // "3,6,12" -> {3, 6, 12}, returns how many were read
+
+        int count = 0;
+
+        while (*text != '\0' && count < MAX_VALUES)
+            {
+                char *end;
+                long value = strtol(text, &end, 10);
+
+                if (end == text)
+                    {
+                        break;
+                    }
+
+                values[count++] = (int)value;
+                text = (*end == ',') ? end + 1 : end;
+            }
+
+        return count;
+    }
+
+static bool write_input(const char *path, int fields, int k, int size, int task_inc, bool invalid)
+    {
+        // writes one inp.txt: a valid sudoku (two cells of the middle row swapped with invalid set)
+
+        FILE *file = fopen(path, "w");
+
+        if (file == NULL)
+            {
+                return false;
+            }
+
+        int n = 1;
+
+        while ((n + 1) * (n + 1) <= size)
+            {
+                n++;
+            }
+
+        if (fields == 3)
+            {
+                fprintf(file, "%d %d %d\n", k, size, task_inc);
+            }
+
+        else
+            {
+                fprintf(file, "%d %d\n", k, size);
+            }
+
+        for (int r = 0; r < size; r++)
+            {
+                for (int c = 0; c < size; c++)
+                    {
+                        int col = c;
+
+                        if (invalid && r == size / 2 && (c == 0 || c == size - 1))
+                            {
+                                col = size - 1 - c;
+                            }
+
+                        fprintf(file, (c + 1 < size) ? "%d " : "%d\n", (n * (r % n) + r / n + col) % size + 1);
+                    }
+            }
+
+        fclose(file);
+        return true;
+    }
+
+static double run_program(const char *dir, const char *program, bool quiet)
+    {
+        // runs one program inside dir with its output to /dev/null. returns its wall time or -1.
+
+        double start = now_us();
+        pid_t pid = fork();
+
+        if (pid < 0)
+            {
+                return -1;
+            }
+
+        if (pid == 0)
+            {
+                int null_fd = open("/dev/null", O_WRONLY);
+
+                if (null_fd >= 0)
+                    {
+                        dup2(null_fd, STDOUT_FILENO);
+                        dup2(null_fd, STDERR_FILENO);
+                    }
+
+                if (chdir(dir) != 0)
+                    {
+                        _exit(127);
+                    }
+
+                if (quiet)
+                    {
+                        execl(program, program, "--quiet", (char *)NULL);
+                    }
+
+                else
+                    {
+                        execl(program, program, (char *)NULL);
+                    }
+
+                _exit(127);
+            }
+
+        int status;
+        waitpid(pid, &status, 0);
+
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+            {
+                return -1;
+            }
+
+        return now_us() - start;
+    }
+
+static bool read_times(const char *path, const char *section, double *validate, double *total, double *claims)
+    {
+        // picks the validation and total times out of a program's output file. Assignment1 files are
+        // split into sections, the sequential and fused methods only print a total, which is all validation.
+
+        FILE *file = fopen(path, "r");
+
+        if (file == NULL)
+            {
+                return false;
+            }
+
+        char line[4096];
+        bool in_section = (section == NULL);
+        *validate = -1;
+        *total = -1;
+        *claims = 0;
+
+        while (fgets(line, sizeof(line), file) != NULL)
+            {
+                if (section != NULL && strstr(line, " method:") != NULL)
+                    {
+                        in_section = (strstr(line, section) != NULL);
+                        continue;
+                    }
+
+                if (!in_section)
+                    {
+                        continue;
+                    }
+
+                double value;
+
+                if (sscanf(line, "The total time taken is %lf", &value) == 1
+                    || sscanf(line, "Time taken to check the validity of the Sudoku: %lf", &value) == 1)
+                    {
+                        *total = value;
+                    }
+
+                else if (sscanf(line, "The time taken for validation is %lf", &value) == 1
+                         || sscanf(line, "Time taken for validation: %lf", &value) == 1)
+                    {
+                        *validate = value;
+                    }
+
+                else if (sscanf(line, "Task ranges claimed per second: %lf", &value) == 1)
+                    {
+                        *claims = value;
+                    }
+            }
+
+        fclose(file);
+
+        if (*validate < 0)
+            {
+                *validate = *total;
+            }
+
+        return *total >= 0;
+    }
+
+static int compare_doubles(const void *a, const void *b)
+    {
+        double x = *(const double *)a, y = *(const double *)b;
+        return (x > y) - (x < y);
+    }
+
+static double percentile(double *values, int count, double p)
+    {
+        // nearest rank on values, which must be sorted
+
+        int rank = (int)(p * count + 0.999999);
+
+        if (rank < 1)
+            {
+                rank = 1;
+            }
+
+        return values[(rank > count ? count : rank) - 1];
+    }
+
+static void print_result(const strategy *strat, int k, int size, int task_inc, samples *s, bool json, bool *first_row)
+    {
+        double *series[4] = {s->validate, s->total, s->process, s->claims};
+
+        for (int i = 0; i < 4; i++)
+            {
+                qsort(series[i], s->count, sizeof(double), compare_doubles);
+            }
+
+        if (json)
+            {
+                printf("%s    {\"strategy\": \"%s\", \"k\": %d, \"n\": %d, \"task_inc\": %d, \"samples\": %d", (*first_row) ? "" : ",\n", strat->name, k, size, task_inc, s->count);
+
+                const char *names[4] = {"validate_us", "total_us", "process_us", "claims_per_second"};
+
+                for (int i = 0; i < 4; i++)
+                    {
+                        printf(", \"%s\": {\"median\": %.2f, \"p90\": %.2f, \"p99\": %.2f}", names[i], percentile(series[i], s->count, 0.5), percentile(series[i], s->count, 0.9), percentile(series[i], s->count, 0.99));
+                    }
+
+                printf("}");
+            }
+
+        else
+            {
+                printf("%s,%d,%d,%d,%d", strat->name, k, size, task_inc, s->count);
+
+                for (int i = 0; i < 4; i++)
+                    {
+                        printf(",%.2f,%.2f,%.2f", percentile(series[i], s->count, 0.5), percentile(series[i], s->count, 0.9), percentile(series[i], s->count, 0.99));
+                    }
+
+                printf("\n");
+            }
+
+        fflush(stdout);
+        *first_row = false;
+    }
+
+int main(int argc, char **argv)
+    {
+        const char *bin_dir = ".";
+        int ks[MAX_VALUES] = {3, 6, 12}, sizes[MAX_VALUES] = {9, 16, 36, 81}, incs[MAX_VALUES] = {1, 4, 16};
+        int no_of_ks = 3, no_of_sizes = 4, no_of_incs = 3;
+        bool selected[NO_OF_STRATEGIES];
+        int warmup = 2, reps = 10;
+        bool json = false, quiet = false, invalid = false;
+
+        for (int i = 0; i < NO_OF_STRATEGIES; i++)
+            {
+                selected[i] = true;
+            }
+
+        for (int i = 1; i < argc; i++)
+            {
+                bool has_value = (i + 1 < argc);
+
+                if (strcmp(argv[i], "-b") == 0 && has_value)
+                    {
+                        bin_dir = argv[++i];
+                    }
+
+                else if (strcmp(argv[i], "-k") == 0 && has_value)
+                    {
+                        no_of_ks = parse_list(argv[++i], ks);
+                    }
+
+                else if (strcmp(argv[i], "-n") == 0 && has_value)
+                    {
+                        no_of_sizes = parse_list(argv[++i], sizes);
+                    }
+
+                else if (strcmp(argv[i], "-i") == 0 && has_value)
+                    {
+                        no_of_incs = parse_list(argv[++i], incs);
+                    }
+
+                else if (strcmp(argv[i], "-s") == 0 && has_value)
+                    {
+                        char list[1024];
+                        snprintf(list, sizeof(list), ",%s,", argv[++i]);
+
+                        for (int s = 0; s < NO_OF_STRATEGIES; s++)
+                            {
+                                char name[64];
+                                snprintf(name, sizeof(name), ",%s,", strategies[s].name);
+                                selected[s] = (strstr(list, name) != NULL);
+                            }
+                    }
+
+                else if (strcmp(argv[i], "-w") == 0 && has_value)
+                    {
+                        warmup = atoi(argv[++i]);
+                    }
+
+                else if (strcmp(argv[i], "-r") == 0 && has_value)
+                    {
+                        reps = atoi(argv[++i]);
+                    }
+
+                else if (strcmp(argv[i], "--json") == 0)
+                    {
+                        json = true;
+                    }
+
+                else if (strcmp(argv[i], "--quiet") == 0)
+                    {
+                        quiet = true;
+                    }
+
+                else if (strcmp(argv[i], "--invalid") == 0)
+                    {
+                        invalid = true;
+                    }
+
+                else
+                    {
+                        printf("usage: %s [-b bin] [-k 3,6,12] [-n 9,16,36,81] [-i 1,4,16] [-s strategies] [-w warmup] [-r samples] [--json] [--quiet] [--invalid]\n", argv[0]);
+                        return -1;
+                    }
+            }
+
+        if (reps < 1)
+            {
+                reps = 1;
+            }
+
+        // the programs run inside a scratch directory, so the binaries are looked up by absolute path
+
+        char bin_path[PATH_MAX];
+
+        if (realpath(bin_dir, bin_path) == NULL)
+            {
+                printf("ERROR: no directory %s\n", bin_dir);
+                return -1;
+            }
+
+        bin_dir = bin_path;
+
+        int first_assignment1 = -1, last_assignment1 = -1;
+
+        for (int i = 0; i < NO_OF_STRATEGIES; i++)
+            {
+                if (strategies[i].section != NULL && selected[i])
+                    {
+                        first_assignment1 = (first_assignment1 < 0) ? i : first_assignment1;
+                        last_assignment1 = i;
+                    }
+            }
+
+        char dir[] = "/tmp/sudoku_bench_XXXXXX";
+
+        if (mkdtemp(dir) == NULL)
+            {
+                printf("ERROR: could not create a scratch directory\n");
+                return -1;
+            }
+
+        char input_path[256], output_path[256], program[PATH_MAX + 64];
+        snprintf(input_path, sizeof(input_path), "%s/inp.txt", dir);
+
+        samples s[NO_OF_STRATEGIES];
+
+        for (int i = 0; i < NO_OF_STRATEGIES; i++)
+            {
+                s[i].validate = (double *)malloc(reps * sizeof(double));
+                s[i].total = (double *)malloc(reps * sizeof(double));
+                s[i].process = (double *)malloc(reps * sizeof(double));
+                s[i].claims = (double *)malloc(reps * sizeof(double));
+            }
+
+        bool first_row = true;
+
+        if (json)
+            {
+                printf("{\"quiet\": %s, \"invalid\": %s, \"warmup\": %d, \"runs\": [\n", quiet ? "true" : "false", invalid ? "true" : "false", warmup);
+            }
+
+        else
+            {
+                printf("strategy,k,n,task_inc,samples,validate_median_us,validate_p90_us,validate_p99_us,total_median_us,total_p90_us,total_p99_us,process_median_us,process_p90_us,process_p99_us,claims_per_second_median,claims_per_second_p90,claims_per_second_p99\n");
+            }
+
+        for (int a = 0; a < no_of_ks; a++)
+            {
+                for (int b = 0; b < no_of_sizes; b++)
+                    {
+                        for (int c = 0; c < no_of_incs; c++)
+                            {
+                                int k = ks[a], size = sizes[b], task_inc = incs[c];
+
+                                for (int st = 0; st < NO_OF_STRATEGIES; st++)
+                                    {
+                                        const strategy *strat = &strategies[st];
+                                        bool assignment1 = (strat->section != NULL);
+
+                                        if (!selected[st] || (assignment1 && (c > 0 || st != first_assignment1)))
+                                            {
+                                                // Assignment1 ignores taskInc, and one run of it samples all its methods
+                                                continue;
+                                            }
+
+                                        int last = assignment1 ? last_assignment1 : st;
+
+                                        write_input(input_path, assignment1 ? 2 : 3, k, size, task_inc, invalid);
+                                        snprintf(program, sizeof(program), "%s/%s", bin_dir, strat->program);
+
+                                        for (int i = st; i <= last; i++)
+                                            {
+                                                s[i].count = 0;
+                                            }
+
+                                        bool failed = false;
+
+                                        for (int rep = -warmup; rep < reps && !failed; rep++)
+                                            {
+                                                double process = run_program(dir, program, quiet);
+                                                failed = (process < 0);
+
+                                                for (int i = st; i <= last && !failed && rep >= 0; i++)
+                                                    {
+                                                        double validate, total, claims;
+                                                        snprintf(output_path, sizeof(output_path), "%s/%s", dir, strategies[i].output);
+
+                                                        if (!read_times(output_path, strategies[i].section, &validate, &total, &claims))
+                                                            {
+                                                                failed = true;
+                                                                break;
+                                                            }
+
+                                                        s[i].validate[s[i].count] = validate;
+                                                        s[i].total[s[i].count] = total;
+                                                        s[i].process[s[i].count] = process;
+                                                        s[i].claims[s[i].count] = claims;
+                                                        s[i].count++;
+                                                    }
+                                            }
+
+                                        if (failed)
+                                            {
+                                                fprintf(stderr, "ERROR: %s failed for K = %d, N = %d, taskInc = %d\n", program, k, size, task_inc);
+                                                continue;
+                                            }
+
+                                        for (int i = st; i <= last; i++)
+                                            {
+                                                if (selected[i])
+                                                    {
+                                                        print_result(&strategies[i], k, size, assignment1 ? 0 : task_inc, &s[i], json, &first_row);
+                                                    }
+                                            }
+                                    }
+                            }
+                    }
+            }
+
+        if (json)
+            {
+                printf("\n]}\n");
+            }
+
+        for (int i = 0; i < NO_OF_STRATEGIES; i++)
+            {
+                free(s[i].validate);
+                free(s[i].total);
+                free(s[i].process);
+                free(s[i].claims);
+            }
+
+        // the scratch directory only holds the input and the output files of the programs
+
+        unlink(input_path);
+
+        for (int i = 0; i < NO_OF_STRATEGIES; i++)
+            {
+                snprintf(output_path, sizeof(output_path), "%s/%s", dir, strategies[i].output);
+                unlink(output_path);
+            }
+
+        rmdir(dir);
+        return 0;
+    }
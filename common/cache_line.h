@@ -0,0 +1,15 @@
+#ifndef CACHE_LINE_H
+#define CACHE_LINE_H
+
+// layout helpers for state that several threads touch.
+//
+// two variables on the same cache line behave as one for the coherence protocol: a write to either
+// takes the line away from every other core, so a thread that only reads its own variable still misses
+// whenever a neighbour writes. shared variables that are written independently (the counter, the lock
+// word, the flags a waiter spins on) and per-thread structs that their threads keep writing get a line
+// each with alignas(CACHE_LINE). the size also pads the type, so arrays of such structs keep the
+// elements apart as well.
+
+#define CACHE_LINE 64   // line size of current x86 and most arm cores
+
+#endif
@@ -0,0 +1,269 @@
+#ifndef GRID_IO_H
+#define GRID_IO_H
+
+// input files for the validators.
+//
+// text files keep the inp.txt layout: a header line (K N for Assignment1, K N taskInc for
+// Assignment2) followed by N x N numbers. a file may hold several puzzles back to back (batch mode).
+// the file is mapped and scanned with a hand written integer parser instead of fscanf / operator>>.
+//
+// binary files start with a 64 byte sudoku_bin_header and then hold 'count' grids of N x stride
+// cells (uint8_t or uint16_t, host byte order) one after the other. grids are used straight out of
+// the mapping without a copy. when stride is a multiple of 64 bytes every row starts on a cache line
+// and the vector column paths can run on the mapped grid too.
+//
+// both kinds are opened with sudoku_source_open, which tells them apart by the magic bytes.
+
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "sudoku_grid.h"
+
+#define SUDOKU_BIN_MAGIC "SDKB"
+#define SUDOKU_BIN_VERSION 1
+
+typedef struct
+    {
+        char magic[4];          // SUDOKU_BIN_MAGIC
+        uint32_t version;       // SUDOKU_BIN_VERSION
+        uint32_t fields;        // header numbers of the text form: 2 (K N) or 3 (K N taskInc)
+        uint32_t threads;       // K
+        uint32_t size;          // N
+        uint32_t task_inc;      // taskInc, 0 when fields == 2
+        uint32_t cell_bytes;    // 1 if N <= 255, else 2 (same rule as sudoku_grid)
+        uint32_t stride;        // cells from the start of one row to the next, >= N
+        uint64_t count;         // grids stored after the header
+        uint8_t reserved[24];   // keeps the header (and so the first grid) 64 bytes long
+
+    } sudoku_bin_header;
+
+typedef struct
+    {
+        // header values of one puzzle
+
+        int threads;    // K
+        int size;       // N
+        int task_inc;   // taskInc, 0 if the input has no such field
+
+    } sudoku_header;
+
+typedef struct
+    {
+        const char *data;       // mapping of the whole file (NULL for an empty file)
+        size_t length;
+        bool binary;
+
+        size_t pos;             // text: byte offset of the next puzzle
+        uint64_t next;          // binary: index of the next grid
+        sudoku_bin_header bin;  // binary: copy of the file header
+
+    } sudoku_source;
+
+static inline bool sudoku_source_open(sudoku_source *src, const char *path)
+    {
+        // maps the file read only. returns false if it cannot be opened or a binary header is broken.
+
+        memset(src, 0, sizeof(*src));
+
+        int fd = open(path, O_RDONLY);
+
+        if (fd < 0)
+            {
+                return false;
+            }
+
+        struct stat info;
+
+        if (fstat(fd, &info) != 0)
+            {
+                close(fd);
+                return false;
+            }
+
+        src->length = (size_t)info.st_size;
+
+        if (src->length > 0)
+            {
+                void *data = mmap(NULL, src->length, PROT_READ, MAP_PRIVATE, fd, 0);
+
+                if (data == MAP_FAILED)
+                    {
+                        close(fd);
+                        return false;
+                    }
+
+                madvise(data, src->length, MADV_SEQUENTIAL);
+                src->data = (const char *)data;
+            }
+
+        close(fd);
+
+        if (src->length >= sizeof(sudoku_bin_header) && memcmp(src->data, SUDOKU_BIN_MAGIC, 4) == 0)
+            {
+                src->binary = true;
+                memcpy(&src->bin, src->data, sizeof(src->bin));
+
+                // count comes from the file, so it is checked by division: count * grid_bytes could
+                // wrap around and pass a comparison against the length
+
+                uint64_t grid_bytes = (uint64_t)src->bin.size * src->bin.stride * src->bin.cell_bytes;
+
+                bool broken = src->bin.version != SUDOKU_BIN_VERSION
+                              || src->bin.size == 0 || src->bin.size > SUDOKU_GRID_MAX_SIZE
+                              || src->bin.stride < src->bin.size
+                              || (src->bin.cell_bytes != 1 && src->bin.cell_bytes != 2)
+                              || src->bin.cell_bytes != (src->bin.size <= 255 ? 1u : 2u)
+                              || grid_bytes == 0
+                              || src->bin.count > (src->length - sizeof(sudoku_bin_header)) / grid_bytes;
+
+                if (broken)
+                    {
+                        munmap((void *)src->data, src->length);
+                        src->data = NULL;
+                        return false;
+                    }
+            }
+
+        return true;
+    }
+
+static inline void sudoku_source_close(sudoku_source *src)
+    {
+        // grids handed out as views are invalid after this
+
+        if (src->data != NULL)
+            {
+                munmap((void *)src->data, src->length);
+            }
+
+        src->data = NULL;
+        src->length = 0;
+    }
+
+static inline bool sudoku_parse_int(const char *data, size_t length, size_t *pos, int *value)
+    {
+        // reads the next whitespace separated integer at *pos. false at the end of the input or if the
+        // next token is not a number.
+
+        size_t i = *pos;
+
+        while (i < length && (unsigned char)data[i] <= ' ')
+            {
+                i++;
+            }
+
+        if (i == length)
+            {
+                *pos = i;
+                return false;
+            }
+
+        bool negative = (data[i] == '-');
+        i += negative;
+
+        if (i == length || (unsigned)(data[i] - '0') > 9)
+            {
+                *pos = i;
+                return false;
+            }
+
+        int result = 0;
+
+        while (i < length && (unsigned)(data[i] - '0') <= 9)
+            {
+                // saturate instead of overflowing, anything this large is out of range anyway
+
+                result = (result > 100000000) ? 1000000000 : result * 10 + (data[i] - '0');
+                i++;
+            }
+
+        *pos = i;
+        *value = negative ? -result : result;
+        return true;
+    }
+
+static inline int sudoku_source_next(sudoku_source *src, int fields, sudoku_header *header, sudoku_grid *grid)
+    {
+        // reads the next puzzle. text puzzles have 'fields' header numbers and are parsed into grid, which
+        // is only reallocated when N changes. binary grids are handed out as views into the mapping.
+        // returns 1 on success, 0 at the end of the input and -1 on a malformed puzzle.
+
+        if (src->binary)
+            {
+                if (src->next >= src->bin.count)
+                    {
+                        return 0;
+                    }
+
+                size_t grid_bytes = (size_t)src->bin.size * src->bin.stride * src->bin.cell_bytes;
+                const char *cells = src->data + sizeof(sudoku_bin_header) + src->next * grid_bytes;
+
+                header->threads = (int)src->bin.threads;
+                header->size = (int)src->bin.size;
+                header->task_inc = (int)src->bin.task_inc;
+
+                sudoku_grid_free(grid);
+                sudoku_grid_view(grid, (int)src->bin.size, (int)src->bin.cell_bytes, src->bin.stride, cells);
+
+                src->next++;
+                return 1;
+            }
+
+        int values[3] = {0, 0, 0};
+
+        for (int f = 0; f < fields; f++)
+            {
+                if (!sudoku_parse_int(src->data, src->length, &src->pos, &values[f]))
+                    {
+                        // running out before the first header number is the normal end of the input
+
+                        return (f == 0 && src->pos == src->length) ? 0 : -1;
+                    }
+            }
+
+        header->threads = values[0];
+        header->size = values[1];
+        header->task_inc = (fields >= 3) ? values[2] : 0;
+
+        int size = header->size;
+
+        if (size <= 0 || size > SUDOKU_GRID_MAX_SIZE)
+            {
+                return -1;
+            }
+
+        if (grid->size != size || grid->view)
+            {
+                sudoku_grid_free(grid);
+
+                if (!sudoku_grid_init(grid, size))
+                    {
+                        return -1;
+                    }
+            }
+
+        for (int i = 0; i < size; i++)
+            {
+                for (int j = 0; j < size; j++)
+                    {
+                        int read_num = 0;
+
+                        if (!sudoku_parse_int(src->data, src->length, &src->pos, &read_num))
+                            {
+                                return -1;
+                            }
+
+                        sudoku_grid_set(grid, i, j, read_num);
+                    }
+            }
+
+        return 1;
+    }
+
+#endif
@@ -0,0 +1,121 @@
+#ifndef GRID_REPLICA_H
+#define GRID_REPLICA_H
+
+// one read-only copy of a grid per NUMA node, for the Assignment2 programs' --numa option.
+//
+// the grid is never written once it is read, so every thread can share the one copy main holds, and
+// by default they do. on a machine with several nodes that copy lives on one of them, and threads on
+// the others read it across the interconnect. grid_replicas_init makes a copy per node, each from a
+// thread pinned to that node, so the first touch (the zero fill in sudoku_grid_init) places its pages
+// there. grid_replicas_place then hands a worker thread the copy of a node and pins it to that node.
+
+#include <pthread.h>
+
+#include "numa_topology.h"
+#include "sudoku_grid.h"
+
+typedef struct
+    {
+        numa_topology topo;
+        sudoku_grid grids[NUMA_MAX_NODES];
+        int count;                              // replicas made, 0 => share the original grid
+
+    } grid_replicas;
+
+typedef struct
+    {
+        const sudoku_grid *src;
+        sudoku_grid *dst;
+        bool ok;
+
+    } grid_replica_job;
+
+static inline void *grid_replica_copy(void *param)
+    {
+        grid_replica_job *job = (grid_replica_job *)param;
+
+        job->ok = sudoku_grid_copy(job->dst, job->src);
+        return NULL;
+    }
+
+static inline int grid_replicas_init(grid_replicas *replicas, const sudoku_grid *src)
+    {
+        // returns the number of replicas made: 0 on a single node machine or if any copy failed, in
+        // which case nothing is left allocated
+
+        replicas->count = 0;
+        numa_topology_load(&replicas->topo);
+
+        if (replicas->topo.nodes < 2)
+            {
+                return 0;
+            }
+
+        bool ok = true;
+
+        for (int n = 0; n < replicas->topo.nodes; n++)
+            {
+                grid_replica_job job = {src, &replicas->grids[n], false};
+                pthread_attr_t attr;
+                pthread_t copier;
+                cpu_set_t set;
+
+                numa_node_cpuset(&replicas->topo, n, &set);
+                pthread_attr_init(&attr);
+                pthread_attr_setaffinity_np(&attr, sizeof(set), &set);
+
+                if (pthread_create(&copier, &attr, grid_replica_copy, &job) == 0)
+                    {
+                        pthread_join(copier, NULL);
+                    }
+
+                pthread_attr_destroy(&attr);
+
+                if (!job.ok)
+                    {
+                        ok = false;
+                        break;
+                    }
+
+                replicas->count++;
+            }
+
+        if (!ok)
+            {
+                for (int n = 0; n < replicas->count; n++)
+                    {
+                        sudoku_grid_free(&replicas->grids[n]);
+                    }
+
+                replicas->count = 0;
+            }
+
+        return replicas->count;
+    }
+
+static inline const sudoku_grid *grid_replicas_place(grid_replicas *replicas, int thread, pthread_attr_t *attr)
+    {
+        // threads are spread over the nodes round robin. attr is pinned to the node of the returned copy,
+        // so the thread created with it stays next to its memory.
+
+        int node = thread % replicas->count;
+        cpu_set_t set;
+
+        numa_node_cpuset(&replicas->topo, node, &set);
+        pthread_attr_setaffinity_np(attr, sizeof(set), &set);
+
+        return &replicas->grids[node];
+    }
+
+static inline void grid_replicas_free(grid_replicas *replicas)
+    {
+        for (int n = 0; n < replicas->count; n++)
+            {
+                sudoku_grid_free(&replicas->grids[n]);
+            }
+
+        replicas->count = 0;
+        numa_topology_free(&replicas->topo);
+    }
+
+#endif
@@ -0,0 +1,165 @@
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+// fixed size log-linear latency histograms (the HDR histogram layout), for the CS entry and hold times
+// and the task claim times of the Assignment2 validators.
+//
+// values are nanoseconds. below 2^LATENCY_SUB_BITS every value has its own bucket; above that each power
+// of two is split into 2^LATENCY_SUB_BITS equal buckets, so a bucket is never wider than 1/64 of the
+// values in it and a percentile read back is within about 1.6% of the true one. values past
+// 2^LATENCY_MAX_BITS ns (about 18 minutes) land in the last bucket. count, sum and max are kept exactly,
+// so the average and the worst case are not rounded.
+//
+// a thread adds to its own histogram while it runs, so the memory stays the same however long the run
+// is, and the histograms of all the threads are merged once they are joined.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define LATENCY_SUB_BITS 6
+#define LATENCY_MAX_BITS 40
+#define LATENCY_SUB_COUNT (1 << LATENCY_SUB_BITS)
+#define LATENCY_BUCKETS ((LATENCY_MAX_BITS - LATENCY_SUB_BITS + 1) * LATENCY_SUB_COUNT)
+
+typedef struct
+    {
+        uint64_t counts[LATENCY_BUCKETS];
+        uint64_t count;
+        uint64_t sum;
+        uint64_t max;
+
+    } latency_histogram;
+
+static inline void latency_histogram_clear(latency_histogram *h)
+    {
+        memset(h, 0, sizeof(*h));
+    }
+
+static inline int latency_bucket(uint64_t ns)
+    {
+        if (ns < LATENCY_SUB_COUNT)
+            {
+                return (int)ns;
+            }
+
+        int msb = 63 - __builtin_clzll(ns);
+        int shift = msb - LATENCY_SUB_BITS;
+        int bucket = (shift + 1) * LATENCY_SUB_COUNT + (int)((ns >> shift) - LATENCY_SUB_COUNT);
+
+        return (bucket < LATENCY_BUCKETS) ? bucket : LATENCY_BUCKETS - 1;
+    }
+
+static inline uint64_t latency_bucket_top(int bucket)
+    {
+        // largest value that falls in bucket
+
+        if (bucket < LATENCY_SUB_COUNT)
+            {
+                return (uint64_t)bucket;
+            }
+
+        int shift = bucket / LATENCY_SUB_COUNT - 1;
+        uint64_t low = (uint64_t)(LATENCY_SUB_COUNT + bucket % LATENCY_SUB_COUNT) << shift;
+
+        return low + ((uint64_t)1 << shift) - 1;
+    }
+
+static inline void latency_histogram_add(latency_histogram *h, uint64_t ns)
+    {
+        h->counts[latency_bucket(ns)]++;
+        h->count++;
+        h->sum += ns;
+        h->max = (ns > h->max) ? ns : h->max;
+    }
+
+static inline void latency_histogram_merge(latency_histogram *into, const latency_histogram *from)
+    {
+        for (int b = 0; b < LATENCY_BUCKETS; b++)
+            {
+                into->counts[b] += from->counts[b];
+            }
+
+        into->count += from->count;
+        into->sum += from->sum;
+        into->max = (from->max > into->max) ? from->max : into->max;
+    }
+
+static inline uint64_t latency_histogram_percentile(const latency_histogram *h, double percent)
+    {
+        // smallest bucket top that at least percent of the values are at or below, never above the max
+
+        if (h->count == 0)
+            {
+                return 0;
+            }
+
+        uint64_t rank = (uint64_t)(percent / 100.0 * h->count + 0.999999);
+        uint64_t seen = 0;
+
+        rank = (rank < 1) ? 1 : (rank > h->count) ? h->count : rank;
+
+        for (int b = 0; b < LATENCY_BUCKETS; b++)
+            {
+                seen += h->counts[b];
+
+                if (seen >= rank)
+                    {
+                        uint64_t top = latency_bucket_top(b);
+                        return (top < h->max) ? top : h->max;
+                    }
+            }
+
+        return h->max;
+    }
+
+static inline double latency_histogram_mean(const latency_histogram *h)
+    {
+        return (h->count > 0) ? (double)h->sum / h->count : 0;
+    }
+
+static inline void latency_histogram_summary(const latency_histogram *h, char *text, size_t size)
+    {
+        // "p50 X, p90 X, p99 X, p99.9 X, max X microseconds"
+
+        snprintf(text, size, "p50 %.3f, p90 %.3f, p99 %.3f, p99.9 %.3f, max %.3f microseconds",
+                 latency_histogram_percentile(h, 50) / 1000.0,
+                 latency_histogram_percentile(h, 90) / 1000.0,
+                 latency_histogram_percentile(h, 99) / 1000.0,
+                 latency_histogram_percentile(h, 99.9) / 1000.0,
+                 h->max / 1000.0);
+    }
+
+static inline bool latency_histogram_csv(const char *path, const char *lock, const char *metric, const latency_histogram *h)
+    {
+        // appends "lock,metric,count,mean_us,p50_us,p90_us,p99_us,p99.9_us,max_us" to path, with the
+        // header first if the file is new, so runs of several locks collect in one table
+
+        FILE *file = fopen(path, "a");
+
+        if (file == NULL)
+            {
+                return false;
+            }
+
+        fseek(file, 0, SEEK_END);
+
+        if (ftell(file) == 0)
+            {
+                fprintf(file, "lock,metric,count,mean_us,p50_us,p90_us,p99_us,p99.9_us,max_us\n");
+            }
+
+        fprintf(file, "%s,%s,%llu,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f\n", lock, metric, (unsigned long long)h->count,
+                latency_histogram_mean(h) / 1000.0,
+                latency_histogram_percentile(h, 50) / 1000.0,
+                latency_histogram_percentile(h, 90) / 1000.0,
+                latency_histogram_percentile(h, 99) / 1000.0,
+                latency_histogram_percentile(h, 99.9) / 1000.0,
+                h->max / 1000.0);
+
+        fclose(file);
+        return true;
+    }
+
+#endif
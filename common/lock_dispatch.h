@@ -0,0 +1,115 @@
+#ifndef LOCK_DISPATCH_H
+#define LOCK_DISPATCH_H
+
+// the Assignment2 validator with the lock left open: lock_dispatch<Lock> is the dispatch policy for
+// run_task_validator (task_validator.h) that hands out taskInc tasks at a time from the shared counter C
+// inside a critical section guarded by a lock policy from lock_policies.h. every lock runs the same
+// measured code path, and the locks and the lock-free policies share the rest of the program.
+// C++ only (g++ -std=c++17).
+
+#include <memory>
+
+#include "task_validator.h"
+#include "lock_policies.h"
+
+template <class Lock>
+struct lock_dispatch : task_policy
+    {
+        static constexpr const char *name = Lock::name;
+        static constexpr const char *output = Lock::output;
+        static constexpr const char *claim_what = "claim tasks";
+
+        struct alignas(CACHE_LINE) cs_times
+            {
+                latency_histogram entry_times;      // ns from requesting the CS to entering it
+                latency_histogram exit_times;       // ns from entering the CS to leaving it
+            };
+
+        Lock lock;
+        alignas(CACHE_LINE) int C = 0;              // the shared counter, written by every lock holder
+        int threads;
+        int tasks;                                  // 3*N
+        int task_inc;
+        std::unique_ptr<cs_times[]> times;          // one per thread, written only by that thread
+        std::unique_ptr<cs_times> merged;           // all the threads, after the joins
+
+        lock_dispatch(int threads, int size, int task_inc) : lock(threads), threads(threads), tasks(3 * size), task_inc(task_inc), times(new cs_times[threads]()), merged(new cs_times()) {}
+
+        bool configure(int argc, char **argv)
+            {
+                lock.configure(argc, argv);
+                return true;
+            }
+
+        void place(int thread, pthread_attr_t *attr)
+            {
+                lock.place(thread, attr);
+            }
+
+        bool next(int thread, task_range *range, trace_buffer *trace)
+            {
+                auto req_time = std::chrono::high_resolution_clock::now();
+                dispatch_log(trace, thread, TRACE_REQUEST);
+
+                lock.lock(thread);     // locking cs
+
+                auto enter_time = std::chrono::high_resolution_clock::now();
+                latency_histogram_add(&times[thread].entry_times, std::chrono::duration_cast<std::chrono::nanoseconds>(enter_time - req_time).count());
+
+                dispatch_log(trace, thread, TRACE_ENTER);
+
+                int task_start = C;          // incrementing shared counter
+                C = std::min(C + task_inc, tasks);
+
+                auto exit_time = std::chrono::high_resolution_clock::now();
+                latency_histogram_add(&times[thread].exit_times, std::chrono::duration_cast<std::chrono::nanoseconds>(exit_time - enter_time).count());
+
+                dispatch_log(trace, thread, TRACE_LEAVE);
+
+                lock.unlock(thread);   // unlocking cs
+
+                // a thread that enters after all the checks were handed out gets nothing
+
+                *range = {task_start, std::min(task_start + task_inc, tasks)};
+                return task_start < tasks;
+            }
+
+        void merge_times()
+            {
+                latency_histogram_clear(&merged->entry_times);
+                latency_histogram_clear(&merged->exit_times);
+
+                for (int i = 0; i < threads; i++)
+                    {
+                        latency_histogram_merge(&merged->entry_times, &times[i].entry_times);
+                        latency_histogram_merge(&merged->exit_times, &times[i].exit_times);
+                    }
+            }
+
+        void report(std::ostream &out)
+            {
+                merge_times();
+
+                char entry_percentiles[160], exit_percentiles[160];
+                latency_histogram_summary(&merged->entry_times, entry_percentiles, sizeof(entry_percentiles));
+                latency_histogram_summary(&merged->exit_times, exit_percentiles, sizeof(exit_percentiles));
+
+                out << "Average time taken by a thread to enter the CS: " << latency_histogram_mean(&merged->entry_times) / 1000.0 << " microseconds" << std::endl;
+                out << "Average time taken by a thread to exit the CS: " << latency_histogram_mean(&merged->exit_times) / 1000.0 << " microseconds" << std::endl;
+                out << "Worst-case time taken by a thread to enter the CS: " << merged->entry_times.max / 1000.0 << " microseconds" << std::endl;
+                out << "Worst-case time taken by a thread to exit the CS: " << merged->exit_times.max / 1000.0 << " microseconds" << std::endl;
+                out << "Time taken by a thread to enter the CS: " << entry_percentiles << std::endl;
+                out << "Time taken by a thread to exit the CS (time it holds the CS): " << exit_percentiles << std::endl;
+
+                lock.report(out);
+            }
+
+        bool csv(const char *path)
+            {
+                merge_times();
+
+                return latency_histogram_csv(path, name, "entry", &merged->entry_times) && latency_histogram_csv(path, name, "hold", &merged->exit_times);
+            }
+    };
+
+#endif
@@ -0,0 +1,677 @@
+#ifndef LOCK_POLICIES_H
+#define LOCK_POLICIES_H
+
+// the locks of the Assignment2 validators, as policies for lock_dispatch (lock_dispatch.h).
+//
+// a policy is a class with
+//     explicit Lock(int threads)               threads are numbered 0 .. threads - 1
+//     void lock(int thread), unlock(int thread)
+//     void configure(int argc, char **argv)    reads its own command line options, if it has any
+//     void report(std::ostream &out)           extra lines after the CS times, if it has any
+//     void place(int thread, pthread_attr_t *attr)
+//                                              where the thread should run, set on attr before it is created
+//     static name, output                      its --lock name and the file the validator writes
+// lock_dispatch is a template over the policy, so lock and unlock are inlined into the claim with no
+// virtual call in between. lock_policy supplies the empty configure, report and place.
+// C++ only (g++ -std=c++17).
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <linux/futex.h>
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "cache_line.h"
+#include "numa_topology.h"
+#include "spin_wait.h"
+
+struct lock_policy
+    {
+        void configure(int /* argc */, char ** /* argv */) {}
+        void report(std::ostream & /* out */) {}
+        void place(int /* thread */, pthread_attr_t * /* attr */) {}
+    };
+
+struct tas_lock : lock_policy
+    {
+        // test-and-set: every waiter keeps writing the flag
+
+        static constexpr const char *name = "tas";
+        static constexpr const char *output = "outputTas.txt";
+
+        alignas(CACHE_LINE) std::atomic_flag flag = ATOMIC_FLAG_INIT;
+
+        explicit tas_lock(int /* threads */) {}
+
+        void lock(int /* thread */)
+            {
+                while (flag.test_and_set()) {}
+            }
+
+        void unlock(int /* thread */)
+            {
+                flag.clear();
+            }
+    };
+
+struct ttas_lock : lock_policy
+    {
+        // test-and-test-and-set: waiters read the flag from their own cached copy and try the exchange
+        // once it reads as free. a thread that loses the exchange backs off for a random, growing number
+        // of pause steps before it reads again.
+
+        static constexpr const char *name = "ttas";
+        static constexpr const char *output = "outputTtas.txt";
+
+        alignas(CACHE_LINE) std::atomic<bool> flag{false};
+
+        explicit ttas_lock(int /* threads */) {}
+
+        void lock(int thread)
+            {
+                spin_backoff backoff;
+                spin_backoff_init(&backoff, thread + 1);
+
+                while (true)
+                    {
+                        while (flag.load(std::memory_order_relaxed))
+                            {
+                                spin_relax();
+                            }
+
+                        if (!flag.exchange(true, std::memory_order_acquire))
+                            {
+                                return;
+                            }
+
+                        spin_backoff_pause(&backoff);
+                    }
+            }
+
+        void unlock(int /* thread */)
+            {
+                flag.store(false, std::memory_order_release);
+            }
+    };
+
+struct ticket_lock : lock_policy
+    {
+        // ticket lock: threads enter in the order in which they took their tickets. a waiting thread
+        // pauses in proportion to how many tickets are still ahead of it, so the line with now_serving is
+        // read roughly once per handoff, and yields the cpu once it has waited long, since with more
+        // threads than cores the next ticket holder may not be running.
+
+        static constexpr const char *name = "ticket";
+        static constexpr const char *output = "outputTicket.txt";
+        static constexpr unsigned BACKOFF_STEP = 32;    // pause steps per thread ahead of us in the queue
+        static constexpr unsigned YIELD_AFTER = 64;     // rounds without our turn before the cpu is given up each round
+
+        alignas(CACHE_LINE) std::atomic<unsigned> next_ticket{0};
+        alignas(CACHE_LINE) std::atomic<unsigned> now_serving{0};
+
+        explicit ticket_lock(int /* threads */) {}
+
+        void lock(int /* thread */)
+            {
+                unsigned my_ticket = next_ticket.fetch_add(1, std::memory_order_relaxed);
+
+                for (unsigned round = 0; ; round++)
+                    {
+                        unsigned serving = now_serving.load(std::memory_order_acquire);
+
+                        if (serving == my_ticket)
+                            {
+                                return;
+                            }
+
+                        if (round >= YIELD_AFTER)
+                            {
+                                sched_yield();
+                                continue;
+                            }
+
+                        unsigned steps = (my_ticket - serving) * BACKOFF_STEP;
+
+                        for (unsigned i = 0; i < steps; i++)
+                            {
+                                spin_relax();
+                            }
+                    }
+            }
+
+        void unlock(int /* thread */)
+            {
+                // only the holder writes now_serving
+
+                now_serving.store(now_serving.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+            }
+
+        bool has_waiters()
+            {
+                // called by the holder: someone took a ticket after ours
+
+                return next_ticket.load(std::memory_order_relaxed) - now_serving.load(std::memory_order_relaxed) > 1;
+            }
+    };
+
+struct mcs_lock : lock_policy
+    {
+        // MCS queue lock: a thread appends its node to the queue with one exchange and then spins only on
+        // its own node, which its predecessor clears on release.
+
+        static constexpr const char *name = "mcs";
+        static constexpr const char *output = "outputMcs.txt";
+
+        struct alignas(CACHE_LINE) node
+            {
+                std::atomic<node *> next;   // the thread that queued up behind this one
+                std::atomic<bool> locked;   // true while this thread has to wait
+            };
+
+        alignas(CACHE_LINE) std::atomic<node *> tail{nullptr};
+        std::unique_ptr<node[]> nodes;      // one per thread, reused by every acquire
+
+        explicit mcs_lock(int threads) : nodes(new node[threads]) {}
+
+        void lock(int thread)
+            {
+                node *mine = &nodes[thread];
+
+                mine->next.store(nullptr, std::memory_order_relaxed);
+                mine->locked.store(true, std::memory_order_relaxed);
+
+                node *pred = tail.exchange(mine, std::memory_order_acq_rel);
+
+                if (pred == nullptr)
+                    {
+                        // the queue was empty
+
+                        return;
+                    }
+
+                pred->next.store(mine, std::memory_order_release);
+
+                uint32_t spins = 0;
+
+                while (mine->locked.load(std::memory_order_acquire))
+                    {
+                        spin_or_yield(&spins);
+                    }
+            }
+
+        void unlock(int thread)
+            {
+                node *mine = &nodes[thread];
+                node *succ = mine->next.load(std::memory_order_acquire);
+
+                if (succ == nullptr)
+                    {
+                        node *expected = mine;
+
+                        if (tail.compare_exchange_strong(expected, nullptr, std::memory_order_release, std::memory_order_relaxed))
+                            {
+                                // nobody is waiting
+
+                                return;
+                            }
+
+                        // a thread has swapped itself into tail but not linked behind us yet
+
+                        uint32_t spins = 0;
+
+                        while ((succ = mine->next.load(std::memory_order_acquire)) == nullptr)
+                            {
+                                spin_or_yield(&spins);
+                            }
+                    }
+
+                succ->locked.store(false, std::memory_order_release);
+            }
+    };
+
+struct clh_lock : lock_policy
+    {
+        // CLH queue lock: a thread marks its node locked, swaps it into tail and spins on the node it got
+        // back, which belongs to the thread just ahead of it. on release the thread keeps its
+        // predecessor's node for the next acquire, so the K + 1 nodes are recycled and nothing is
+        // allocated while the threads run.
+
+        static constexpr const char *name = "clh";
+        static constexpr const char *output = "outputClh.txt";
+
+        struct alignas(CACHE_LINE) node
+            {
+                std::atomic<bool> locked{false};
+            };
+
+        struct alignas(CACHE_LINE) slot
+            {
+                node *mine;     // node this thread queues with next
+                node *pred;     // node this thread waits on, kept from lock to unlock
+            };
+
+        node dummy;                                 // first node of the queue, never locked
+        alignas(CACHE_LINE) std::atomic<node *> tail{&dummy};
+        std::unique_ptr<node[]> nodes;
+        std::unique_ptr<slot[]> slots;
+
+        explicit clh_lock(int threads) : nodes(new node[threads]), slots(new slot[threads])
+            {
+                for (int i = 0; i < threads; i++)
+                    {
+                        slots[i].mine = &nodes[i];
+                        slots[i].pred = nullptr;
+                    }
+            }
+
+        void lock(int thread)
+            {
+                slot &s = slots[thread];
+
+                s.mine->locked.store(true, std::memory_order_relaxed);
+                s.pred = tail.exchange(s.mine, std::memory_order_acq_rel);
+
+                uint32_t spins = 0;
+
+                while (s.pred->locked.load(std::memory_order_acquire))
+                    {
+                        spin_or_yield(&spins);
+                    }
+            }
+
+        void unlock(int thread)
+            {
+                slot &s = slots[thread];
+                node *released = s.mine;
+
+                s.mine = s.pred;
+                released->locked.store(false, std::memory_order_release);
+            }
+    };
+
+struct cas_lock : lock_policy
+    {
+        // compare-and-swap spinning on one word
+
+        static constexpr const char *name = "cas";
+        static constexpr const char *output = "outputCas.txt";
+
+        alignas(CACHE_LINE) std::atomic<int> lock_value{0};    // 1 => locked
+
+        explicit cas_lock(int /* threads */) {}
+
+        void lock(int /* thread */)
+            {
+                int expected = 0;
+
+                while (!lock_value.compare_exchange_strong(expected, 1))
+                    {
+                        expected = 0;   // compare_exchange_strong stored the 1 it found
+                    }
+            }
+
+        void unlock(int /* thread */)
+            {
+                lock_value.store(0);
+            }
+    };
+
+struct bcas_lock : lock_policy
+    {
+        // bounded waiting with compare-and-swap, as given in the book: a waiter raises its flag and
+        // spins until it either wins the cas itself or the holder hands it the lock by lowering the
+        // flag. the holder scans the flags round robin from where the last handoff stopped, so every
+        // waiter is served within K handoffs.
+
+        static constexpr const char *name = "bcas";
+        static constexpr const char *output = "outputBoundedcas.txt";
+
+        struct alignas(CACHE_LINE) waiting_flag
+            {
+                std::atomic<bool> waiting{false};   // every flag on its own line, a waiter spins on it
+            };
+
+        int threads;
+        alignas(CACHE_LINE) std::atomic<int> lock_value{0};
+        alignas(CACHE_LINE) std::atomic<int> waiting_threads{0};
+        alignas(CACHE_LINE) std::atomic<int> next_thread{0};
+        std::unique_ptr<waiting_flag[]> waiting_flags;
+
+        explicit bcas_lock(int threads) : threads(threads), waiting_flags(new waiting_flag[threads]) {}
+
+        void lock(int thread)
+            {
+                waiting_flags[thread].waiting.store(true);
+                waiting_threads.fetch_add(1);
+
+                bool key = true;
+
+                while (waiting_flags[thread].waiting.load() && key)
+                    {
+                        int expected = 0;
+                        key = !lock_value.compare_exchange_strong(expected, 1);
+                    }
+
+                waiting_flags[thread].waiting.store(false);
+
+                if (key)
+                    {
+                        int expected = 0;
+
+                        while (!lock_value.compare_exchange_strong(expected, 1))
+                            {
+                                expected = 0;
+                            }
+                    }
+
+                waiting_threads.fetch_sub(1);
+            }
+
+        void unlock(int /* thread */)
+            {
+                if (waiting_threads.load() > 0)
+                    {
+                        int current = next_thread.load();
+                        int start = current;
+
+                        do
+                            {
+                                if (waiting_flags[current].waiting.load())
+                                    {
+                                        waiting_flags[current].waiting.store(false);
+                                        next_thread.store((current + 1) % threads);
+                                        break;
+                                    }
+
+                                current = (current + 1) % threads;
+
+                            } while (current != start);
+                    }
+
+                lock_value.store(0);
+            }
+    };
+
+struct futex_lock : lock_policy
+    {
+        // spin-then-park: the lock is tried with a cas for up to spin_limit pause steps, which is enough
+        // while the holder is running and about to leave. after that the thread marks the word as
+        // contended (2) and sleeps in the kernel until the holder wakes it, so a waiter whose holder was
+        // preempted stops burning its timeslice. --spin steps sets the limit, otherwise it is calibrated.
+
+        static constexpr const char *name = "futex";
+        static constexpr const char *output = "outputFutex.txt";
+
+        struct alignas(CACHE_LINE) park_count
+            {
+                int parks = 0;      // times the thread gave up spinning and slept
+            };
+
+        alignas(CACHE_LINE) std::atomic<int> lock_word{0};     // 0 => free, 1 => locked, 2 => locked and a thread may be parked
+        int spin_limit = -1;
+        int threads;
+        std::unique_ptr<park_count[]> counts;
+
+        explicit futex_lock(int threads) : threads(threads), counts(new park_count[threads]) {}
+
+        static long futex(std::atomic<int> *word, int op, int value)
+            {
+                // the futex calls work on the int inside the atomic, which has the same size and layout
+
+                return syscall(SYS_futex, reinterpret_cast<int *>(word), op, value, nullptr, nullptr, 0);
+            }
+
+        static int calibrate_spin_limit()
+            {
+                // spinning pays as long as it costs less than parking would. a park is at least a
+                // FUTEX_WAIT for the waiter and a FUTEX_WAKE for the holder, so the limit is the number of
+                // pause steps that take as long as two system calls, timed here with a wake that finds
+                // nobody to wake.
+
+                std::atomic<int> dummy(0);
+                const int calls = 500;
+                const int steps = 20000;
+
+                auto start = std::chrono::steady_clock::now();
+
+                for (int i = 0; i < calls; i++)
+                    {
+                        futex(&dummy, FUTEX_WAKE_PRIVATE, 1);
+                    }
+
+                auto middle = std::chrono::steady_clock::now();
+
+                for (int i = 0; i < steps; i++)
+                    {
+                        spin_relax();
+                    }
+
+                auto end = std::chrono::steady_clock::now();
+
+                double call_ns = std::chrono::duration<double, std::nano>(middle - start).count() / calls;
+                double step_ns = std::chrono::duration<double, std::nano>(end - middle).count() / steps;
+                int limit = (int)(2 * call_ns / (step_ns > 0.1 ? step_ns : 0.1));
+
+                return (limit < 16) ? 16 : (limit > (1 << 16)) ? (1 << 16) : limit;
+            }
+
+        void configure(int argc, char **argv)
+            {
+                for (int i = 1; i + 1 < argc; i++)
+                    {
+                        if (std::string(argv[i]) == "--spin")
+                            {
+                                spin_limit = std::max(atoi(argv[i + 1]), 0);
+                            }
+                    }
+
+                if (spin_limit < 0)
+                    {
+                        spin_limit = calibrate_spin_limit();
+                    }
+            }
+
+        void lock(int thread)
+            {
+                for (int i = 0; i < spin_limit; i++)
+                    {
+                        int expected = 0;
+
+                        if (lock_word.load(std::memory_order_relaxed) == 0 && lock_word.compare_exchange_weak(expected, 1, std::memory_order_acquire))
+                            {
+                                return;
+                            }
+
+                        spin_relax();
+                    }
+
+                // taking the lock from here on leaves it at 2, since other threads may still be parked
+
+                while (lock_word.exchange(2, std::memory_order_acquire) != 0)
+                    {
+                        counts[thread].parks++;
+                        futex(&lock_word, FUTEX_WAIT_PRIVATE, 2);      // returns at once if the word is no longer 2
+                    }
+            }
+
+        void unlock(int /* thread */)
+            {
+                // a system call only if someone may be asleep
+
+                if (lock_word.exchange(0, std::memory_order_release) == 2)
+                    {
+                        futex(&lock_word, FUTEX_WAKE_PRIVATE, 1);
+                    }
+            }
+
+        void report(std::ostream &out)
+            {
+                int parks = 0;
+
+                for (int i = 0; i < threads; i++)
+                    {
+                        parks += counts[i].parks;
+                    }
+
+                out << "Times a thread parked on the futex: " << parks << " (spin limit " << spin_limit << " steps)" << std::endl;
+            }
+    };
+
+struct cohort_lock : lock_policy
+    {
+        // cohort lock: a ticket_lock per NUMA node and a global ticket_lock between the nodes. a thread
+        // first queues on the lock of its own node, and the winner also needs the global lock unless the
+        // previous holder of the node lock passed it on with it. a holder with a waiter on its own node
+        // hands it both, up to handoff_budget times in a row, so the lock and the lines it protects stay
+        // on one node. after that, or when nobody on the node waits, the global lock is released so the
+        // other nodes get their turn. a ticket lock does not care which thread releases it, so the global
+        // lock can change hands inside a cohort without being released.
+        // threads are spread over the nodes round robin and pinned there by place. --budget handoffs
+        // sets the budget, --cohorts count makes that many unpinned groups instead of one per node, to
+        // try the lock on a single node machine.
+
+        static constexpr const char *name = "cohort";
+        static constexpr const char *output = "outputCohort.txt";
+
+        struct alignas(CACHE_LINE) cohort
+            {
+                // owns_global and local_handoffs are only used by the holder of the local lock, which
+                // orders them, so they are plain variables
+
+                ticket_lock local{0};
+                bool owns_global = false;       // the global lock is held on behalf of this cohort
+                int local_handoffs = 0;         // handoffs inside the cohort since it took the global lock
+            };
+
+        struct alignas(CACHE_LINE) handoff_count
+            {
+                int acquisitions = 0;
+                int remote_handoffs = 0;        // times the thread took the global lock over from another cohort
+                int local_passes = 0;           // times the thread passed the lock on inside its cohort
+            };
+
+        ticket_lock global{0};
+        int last_cohort = -1;                   // cohort that held the global lock last, only used under it
+        int threads;
+        int handoff_budget = 64;
+        int no_of_cohorts = 1;
+        bool pin = false;
+        numa_topology topo;
+        std::unique_ptr<cohort[]> cohorts;
+        std::unique_ptr<handoff_count[]> counts;
+
+        explicit cohort_lock(int threads) : threads(threads), counts(new handoff_count[threads])
+            {
+                numa_topology_load(&topo);
+                make_cohorts(0);
+            }
+
+        ~cohort_lock()
+            {
+                numa_topology_free(&topo);
+            }
+
+        void make_cohorts(int count)
+            {
+                // count > 0 makes that many unpinned groups, 0 one cohort per node, pinned if there are several
+
+                no_of_cohorts = (count > 0) ? count : topo.nodes;
+                pin = (count == 0 && topo.nodes > 1);
+                cohorts.reset(new cohort[no_of_cohorts]);
+            }
+
+        void configure(int argc, char **argv)
+            {
+                for (int i = 1; i + 1 < argc; i++)
+                    {
+                        if (std::string(argv[i]) == "--budget")
+                            {
+                                handoff_budget = std::max(atoi(argv[i + 1]), 0);
+                            }
+
+                        else if (std::string(argv[i]) == "--cohorts")
+                            {
+                                make_cohorts(std::max(atoi(argv[i + 1]), 0));
+                            }
+                    }
+            }
+
+        void place(int thread, pthread_attr_t *attr)
+            {
+                // pins the thread to the node of its cohort
+
+                if (pin)
+                    {
+                        cpu_set_t set;
+                        numa_node_cpuset(&topo, thread % no_of_cohorts, &set);
+                        pthread_attr_setaffinity_np(attr, sizeof(set), &set);
+                    }
+            }
+
+        void lock(int thread)
+            {
+                int mine = thread % no_of_cohorts;
+                cohort *own = &cohorts[mine];
+
+                own->local.lock(thread);
+
+                if (!own->owns_global)
+                    {
+                        global.lock(thread);
+                        own->owns_global = true;
+
+                        if (last_cohort != mine)
+                            {
+                                // the lock (and the lines it protects) comes from another node
+
+                                counts[thread].remote_handoffs += (last_cohort >= 0);
+                                last_cohort = mine;
+                            }
+                    }
+
+                counts[thread].acquisitions++;
+            }
+
+        void unlock(int thread)
+            {
+                cohort *own = &cohorts[thread % no_of_cohorts];
+
+                if (own->local.has_waiters() && own->local_handoffs < handoff_budget)
+                    {
+                        own->local_handoffs++;
+                        counts[thread].local_passes++;
+                    }
+
+                else
+                    {
+                        own->local_handoffs = 0;
+                        own->owns_global = false;
+                        global.unlock(thread);
+                    }
+
+                own->local.unlock(thread);
+            }
+
+        void report(std::ostream &out)
+            {
+                int acquisitions = 0, remote_handoffs = 0, local_passes = 0;
+
+                for (int i = 0; i < threads; i++)
+                    {
+                        acquisitions += counts[i].acquisitions;
+                        remote_handoffs += counts[i].remote_handoffs;
+                        local_passes += counts[i].local_passes;
+                    }
+
+                out << "Lock handoffs between NUMA nodes: " << remote_handoffs << " of " << acquisitions << " acquisitions" << std::endl;
+                out << "Lock handoffs kept inside a node: " << local_passes << " (" << no_of_cohorts << " cohorts, budget " << handoff_budget << ")" << std::endl;
+            }
+    };
+
+#endif
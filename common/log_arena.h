@@ -0,0 +1,135 @@
+#ifndef LOG_ARENA_H
+#define LOG_ARENA_H
+
+// append-only message buffer for one thread.
+//
+// a worker formats its messages straight onto the end of the arena (the write offset is kept, so
+// nothing is rescanned the way strcat does) and the owner writes the whole arena with one fwrite after
+// the join. the buffer grows in whole chunks and at least doubles each time, so a long run does a
+// handful of reallocs instead of one per message.
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define LOG_ARENA_CHUNK 4096    // growth granularity in bytes
+
+typedef struct
+    {
+        char *data;     // messages written so far, not null terminated
+        size_t len;     // write offset
+        size_t cap;     // bytes allocated
+        bool muted;     // messages are dropped without being formatted
+
+    } log_arena;
+
+static inline bool log_arena_reserve(log_arena *arena, size_t extra)
+    {
+        // makes room for 'extra' more bytes after the write offset
+
+        if (arena->len + extra <= arena->cap)
+            {
+                return true;
+            }
+
+        size_t cap = arena->cap * 2;
+
+        if (cap < arena->len + extra)
+            {
+                cap = arena->len + extra;
+            }
+
+        cap = (cap + LOG_ARENA_CHUNK - 1) / LOG_ARENA_CHUNK * LOG_ARENA_CHUNK;
+
+        char *data = (char *)realloc(arena->data, cap);
+
+        if (data == NULL)
+            {
+                return false;
+            }
+
+        arena->data = data;
+        arena->cap = cap;
+        return true;
+    }
+
+static inline void log_arena_init(log_arena *arena, size_t expected_bytes)
+    {
+        // expected_bytes is only a hint for the first allocation
+
+        arena->data = NULL;
+        arena->len = 0;
+        arena->cap = 0;
+        arena->muted = false;
+
+        log_arena_reserve(arena, expected_bytes > 0 ? expected_bytes : LOG_ARENA_CHUNK);
+    }
+
+static inline void log_arena_printf(log_arena *arena, const char *format, ...)
+    {
+        // appends one formatted message. a message that does not fit is formatted a second time after
+        // the arena grows. on allocation failure the message is dropped.
+
+        if (arena->muted)
+            {
+                return;
+            }
+
+        va_list args;
+
+        va_start(args, format);
+        size_t room = arena->cap - arena->len;
+        int written = vsnprintf(arena->data ? arena->data + arena->len : NULL, room, format, args);
+        va_end(args);
+
+        if (written < 0)
+            {
+                return;
+            }
+
+        if ((size_t)written >= room)
+            {
+                // vsnprintf needs space for its terminator even though the arena does not keep it
+
+                if (!log_arena_reserve(arena, (size_t)written + 1))
+                    {
+                        return;
+                    }
+
+                va_start(args, format);
+                vsnprintf(arena->data + arena->len, (size_t)written + 1, format, args);
+                va_end(args);
+            }
+
+        arena->len += (size_t)written;
+    }
+
+static inline void log_arena_mute(log_arena *arena, bool muted)
+    {
+        // a muted arena keeps its buffer but ignores log_arena_printf, for runs that only want the timings
+
+        arena->muted = muted;
+    }
+
+static inline void log_arena_flush(log_arena *arena, FILE *out)
+    {
+        // writes everything in one go and resets the write offset
+
+        if (arena->len > 0)
+            {
+                fwrite(arena->data, 1, arena->len, out);
+            }
+
+        arena->len = 0;
+    }
+
+static inline void log_arena_free(log_arena *arena)
+    {
+        free(arena->data);
+        arena->data = NULL;
+        arena->len = 0;
+        arena->cap = 0;
+    }
+
+#endif
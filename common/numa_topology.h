@@ -0,0 +1,176 @@
+#ifndef NUMA_TOPOLOGY_H
+#define NUMA_TOPOLOGY_H
+
+// which cpus belong to which NUMA node, read from sysfs (/sys/devices/system/node) so that nothing
+// beyond libc is needed. a machine without that directory, or with a single node, is reported as one
+// node holding every online cpu.
+//
+// cpu_set_t needs _GNU_SOURCE, which g++ always defines. a C program has to define it before its first
+// #include.
+
+#include <sched.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define NUMA_MAX_NODES 64       // nodes past this many are ignored
+#ifndef NUMA_SYSFS
+#define NUMA_SYSFS "/sys/devices/system/node"     // can be pointed elsewhere at compile time
+#endif
+
+typedef struct
+    {
+        int nodes;                          // number of nodes found, at least 1 once loaded
+        int node_id[NUMA_MAX_NODES];        // sysfs number of each node (they need not be contiguous)
+        int cpu_count[NUMA_MAX_NODES];
+        int *cpus[NUMA_MAX_NODES];          // cpu numbers of each node
+
+    } numa_topology;
+
+static inline int numa_parse_list(const char *list, int *out, int max)
+    {
+        // parses a sysfs list such as "0-3,8,10-11" into out, returns how many numbers it held
+
+        int count = 0;
+        const char *p = list;
+
+        while (*p != '\0' && *p != '\n')
+            {
+                char *end;
+                long first = strtol(p, &end, 10);
+                long last = first;
+
+                if (end == p)
+                    {
+                        break;
+                    }
+
+                if (*end == '-')
+                    {
+                        p = end + 1;
+                        last = strtol(p, &end, 10);
+                    }
+
+                for (long v = first; v <= last && count < max; v++)
+                    {
+                        out[count++] = (int)v;
+                    }
+
+                p = (*end == ',') ? end + 1 : end;
+            }
+
+        return count;
+    }
+
+static inline int numa_read_list(const char *path, int *out, int max)
+    {
+        // reads and parses one sysfs list file, -1 if it cannot be read
+
+        char buffer[4096];
+        FILE *file = fopen(path, "r");
+
+        if (file == NULL)
+            {
+                return -1;
+            }
+
+        bool ok = (fgets(buffer, sizeof(buffer), file) != NULL);
+        fclose(file);
+
+        return ok ? numa_parse_list(buffer, out, max) : -1;
+    }
+
+static inline void numa_topology_load(numa_topology *topo)
+    {
+        int ids[NUMA_MAX_NODES];
+        int cpus[CPU_SETSIZE];
+        int node_count = numa_read_list(NUMA_SYSFS "/online", ids, NUMA_MAX_NODES);
+
+        topo->nodes = 0;
+
+        for (int i = 0; i < node_count; i++)
+            {
+                char path[128];
+                snprintf(path, sizeof(path), NUMA_SYSFS "/node%d/cpulist", ids[i]);
+
+                int cpu_count = numa_read_list(path, cpus, CPU_SETSIZE);
+
+                if (cpu_count <= 0)
+                    {
+                        // memory only nodes have no cpus to run threads on
+
+                        continue;
+                    }
+
+                topo->node_id[topo->nodes] = ids[i];
+                topo->cpu_count[topo->nodes] = cpu_count;
+                topo->cpus[topo->nodes] = (int *)malloc(cpu_count * sizeof(int));
+                memcpy(topo->cpus[topo->nodes], cpus, cpu_count * sizeof(int));
+                topo->nodes++;
+            }
+
+        if (topo->nodes == 0)
+            {
+                // no sysfs information: one node with every online cpu
+
+                int online = (int)sysconf(_SC_NPROCESSORS_ONLN);
+
+                topo->node_id[0] = 0;
+                topo->cpu_count[0] = (online > 0) ? online : 1;
+                topo->cpus[0] = (int *)malloc(topo->cpu_count[0] * sizeof(int));
+
+                for (int c = 0; c < topo->cpu_count[0]; c++)
+                    {
+                        topo->cpus[0][c] = c;
+                    }
+
+                topo->nodes = 1;
+            }
+    }
+
+static inline void numa_topology_free(numa_topology *topo)
+    {
+        for (int n = 0; n < topo->nodes; n++)
+            {
+                free(topo->cpus[n]);
+            }
+
+        topo->nodes = 0;
+    }
+
+static inline int numa_node_of_cpu(const numa_topology *topo, int cpu)
+    {
+        // index (not sysfs number) of the node holding cpu, 0 if the cpu is not listed
+
+        for (int n = 0; n < topo->nodes; n++)
+            {
+                for (int c = 0; c < topo->cpu_count[n]; c++)
+                    {
+                        if (topo->cpus[n][c] == cpu)
+                            {
+                                return n;
+                            }
+                    }
+            }
+
+        return 0;
+    }
+
+static inline void numa_node_cpuset(const numa_topology *topo, int node, cpu_set_t *set)
+    {
+        // every cpu of the node, for pthread_attr_setaffinity_np
+
+        CPU_ZERO(set);
+
+        for (int c = 0; c < topo->cpu_count[node]; c++)
+            {
+                if (topo->cpus[node][c] < CPU_SETSIZE)
+                    {
+                        CPU_SET(topo->cpus[node][c], set);
+                    }
+            }
+    }
+
+#endif
@@ -0,0 +1,85 @@
+#ifndef SPIN_WAIT_H
+#define SPIN_WAIT_H
+
+// helpers for the busy-wait loops of the Assignment2 locks.
+//
+// spin_relax is the cpu's spin-loop hint (pause on x86, yield on arm): it lets the sibling hyperthread
+// run and keeps the core from flooding the memory system with speculative loads of the lock line.
+// spin_backoff waits a random number of relax steps that doubles after every failed attempt, so
+// threads that lost the same race do not all retry at the same moment.
+// spin_or_yield is for the queue locks, where a waiter spins on its own flag: it gives up the cpu once it
+// has spun for a while, since with more threads than cores the thread it waits for may not be running.
+
+#include <sched.h>
+#include <stdint.h>
+
+#define SPIN_BACKOFF_MIN 4      // relax steps after the first failed attempt
+#define SPIN_BACKOFF_MAX 4096   // upper bound of the doubling
+#define SPIN_YIELD_AFTER 1024   // relax steps before spin_or_yield starts yielding
+
+static inline void spin_relax(void)
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+        __asm__ __volatile__("yield");
+#else
+        __asm__ __volatile__("" ::: "memory");
+#endif
+    }
+
+static inline void spin_or_yield(uint32_t *spins)
+    {
+        // one step of a wait loop, *spins counts the steps taken so far (start it at 0)
+
+        if (*spins < SPIN_YIELD_AFTER)
+            {
+                (*spins)++;
+                spin_relax();
+            }
+
+        else
+            {
+                sched_yield();
+            }
+    }
+
+typedef struct
+    {
+        uint32_t limit;     // current upper bound of the wait, in relax steps
+        uint32_t seed;      // xorshift state for the jitter
+
+    } spin_backoff;
+
+static inline void spin_backoff_init(spin_backoff *backoff, uint32_t seed)
+    {
+        // seed should differ per thread (the thread id will do) so the jitter differs too
+
+        backoff->limit = SPIN_BACKOFF_MIN;
+        backoff->seed = seed * 2654435761u + 1;
+    }
+
+static inline void spin_backoff_pause(spin_backoff *backoff)
+    {
+        // waits between limit / 2 and limit relax steps, then doubles limit
+
+        uint32_t x = backoff->seed;
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        backoff->seed = x;
+
+        uint32_t steps = backoff->limit / 2 + x % (backoff->limit / 2 + 1);
+
+        for (uint32_t i = 0; i < steps; i++)
+            {
+                spin_relax();
+            }
+
+        if (backoff->limit < SPIN_BACKOFF_MAX)
+            {
+                backoff->limit *= 2;
+            }
+    }
+
+#endif
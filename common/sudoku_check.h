@@ -0,0 +1,189 @@
+#ifndef SUDOKU_CHECK_H
+#define SUDOKU_CHECK_H
+
+// validation kernels shared by the Assignment1 and Assignment2 programs.
+//
+// a row, column or subgrid of an N x N sudoku is valid when it holds every number 1..N exactly once.
+// instead of a malloc'd bool array per check, the numbers that have been seen are tracked as bits in
+// 64-bit words: a single uint64_t when N <= 64 and a fixed stack array of words above that.
+// a region is valid exactly when all N bits end up set, since N cells can only set N distinct bits if
+// there is no repeat. this lets the loops run without a branch per cell.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "sudoku_grid.h"
+
+#define DIGIT_SET_MAX_SIZE 65536                        // largest N the kernels accept
+#define DIGIT_SET_MAX_WORDS (DIGIT_SET_MAX_SIZE / 64)
+
+typedef struct
+    {
+        // bitset of the numbers seen so far, bit (d - 1) is set once the number d is read.
+        // only the first digit_set_words(size) words are used.
+
+        uint64_t words[DIGIT_SET_MAX_WORDS];
+
+    } digit_set;
+
+static inline int digit_set_words(int size)
+    {
+        // number of 64-bit words needed for the numbers 1..size
+
+        return (size + 63) >> 6;
+    }
+
+static inline uint64_t digit_mask_full(int size)
+    {
+        // mask with the lowest 'size' bits set (size <= 64)
+
+        return (size >= 64) ? ~(uint64_t)0 : (((uint64_t)1 << size) - 1);
+    }
+
+static inline uint64_t digit_bit(int size, int value)
+    {
+        // bit for 'value' in a single word mask, or 0 when value is outside 1..size (size <= 64)
+
+        unsigned idx = (unsigned)(value - 1);
+        uint64_t in_range = (uint64_t)0 - (uint64_t)(idx < (unsigned)size);
+
+        return ((uint64_t)1 << (idx & 63)) & in_range;
+    }
+
+static inline void digit_set_clear(digit_set *set, int size)
+    {
+        int words = digit_set_words(size);
+
+        for (int i = 0; i < words; i++)
+            {
+                set->words[i] = 0;
+            }
+    }
+
+static inline void digit_words_add(uint64_t *words, int size, int value)
+    {
+        // marks 'value' as seen in a raw word array. out of range values are folded onto word 0 with an
+        // empty bit so that they simply leave a hole in the set.
+
+        unsigned idx = (unsigned)(value - 1);
+        uint64_t in_range = (uint64_t)0 - (uint64_t)(idx < (unsigned)size);
+
+        words[(idx >> 6) & (unsigned)in_range] |= ((uint64_t)1 << (idx & 63)) & in_range;
+    }
+
+static inline bool digit_words_full(const uint64_t *words, int size)
+    {
+        // true if every number 1..size has been seen
+
+        int count = digit_set_words(size);
+        uint64_t missing = 0;
+
+        for (int i = 0; i < count - 1; i++)
+            {
+                missing |= ~words[i];
+            }
+
+        int tail = size - 64 * (count - 1);
+        missing |= words[count - 1] ^ digit_mask_full(tail);
+
+        return missing == 0;
+    }
+
+static inline void digit_set_add(digit_set *set, int size, int value)
+    {
+        digit_words_add(set->words, size, value);
+    }
+
+static inline bool digit_set_full(const digit_set *set, int size)
+    {
+        return digit_words_full(set->words, size);
+    }
+
+// block kernels for each cell width. a row is a 1 x size block, a column is size x 1 and a subgrid is
+// sqrt(size) x sqrt(size); 'first' points at the top left cell and 'stride' is the row pitch in cells.
+
+#define SUDOKU_DEFINE_BLOCK_KERNEL(name, cell_t)                                                    \
+static inline bool name(const cell_t *first, size_t stride, int size, int height, int width)        \
+    {                                                                                               \
+        if (size <= 64)                                                                             \
+            {                                                                                       \
+                uint64_t seen = 0;                                                                  \
+                                                                                                    \
+                for (int i = 0; i < height; i++, first += stride)                                   \
+                    {                                                                               \
+                        for (int j = 0; j < width; j++)                                             \
+                            {                                                                       \
+                                seen |= digit_bit(size, first[j]);                                  \
+                            }                                                                       \
+                    }                                                                               \
+                                                                                                    \
+                return seen == digit_mask_full(size);                                               \
+            }                                                                                       \
+                                                                                                    \
+        if (size > DIGIT_SET_MAX_SIZE)                                                              \
+            {                                                                                       \
+                return false;                                                                       \
+            }                                                                                       \
+                                                                                                    \
+        digit_set seen;                                                                             \
+        digit_set_clear(&seen, size);                                                               \
+                                                                                                    \
+        for (int i = 0; i < height; i++, first += stride)                                           \
+            {                                                                                       \
+                for (int j = 0; j < width; j++)                                                     \
+                    {                                                                               \
+                        digit_set_add(&seen, size, first[j]);                                       \
+                    }                                                                               \
+            }                                                                                       \
+                                                                                                    \
+        return digit_set_full(&seen, size);                                                         \
+    }
+
+SUDOKU_DEFINE_BLOCK_KERNEL(sudoku_check_block_u8, uint8_t)
+SUDOKU_DEFINE_BLOCK_KERNEL(sudoku_check_block_u16, uint16_t)
+
+static inline bool sudoku_check_block(const sudoku_grid *grid, int row, int col, int height, int width)
+    {
+        // validates the height x width block whose top left cell is (row, col)
+
+        if (grid->cell_bytes == 1)
+            {
+                return sudoku_check_block_u8(sudoku_grid_row8(grid, row) + col, grid->stride, grid->size, height, width);
+            }
+
+        return sudoku_check_block_u16(sudoku_grid_row16(grid, row) + col, grid->stride, grid->size, height, width);
+    }
+
+static inline int sudoku_box_size(int size)
+    {
+        // dimension of a subgrid, i.e. the integer square root of N
+
+        int n = 0;
+
+        while ((n + 1) * (n + 1) <= size)
+            {
+                n++;
+            }
+
+        return n;
+    }
+
+static inline bool sudoku_check_row(const sudoku_grid *grid, int row)
+    {
+        return sudoku_check_block(grid, row, 0, 1, grid->size);
+    }
+
+static inline bool sudoku_check_col(const sudoku_grid *grid, int col)
+    {
+        return sudoku_check_block(grid, 0, col, grid->size, 1);
+    }
+
+static inline bool sudoku_check_subgrid(const sudoku_grid *grid, int row, int col)
+    {
+        int n = sudoku_box_size(grid->size);
+
+        return sudoku_check_block(grid, row, col, n, n);
+    }
+
+#endif
@@ -0,0 +1,578 @@
+#ifndef SUDOKU_COLS_H
+#define SUDOKU_COLS_H
+
+// streaming column validation.
+//
+// checking one column at a time walks the grid with a stride of a whole row, which is one cache miss
+// per cell once N gets large. the engine below instead walks the grid row by row and keeps a seen
+// mask per column, so a batch of columns is checked in a single sequential pass.
+//
+// vector paths, picked at runtime:
+//     N <= 64 (uint8_t cells), one mask per column kept in registers
+//         AVX2    - 32 columns per row step for N <= 32 (32-bit masks), 16 columns for N <= 64 (64-bit masks)
+//         SSE4.2  - 16 columns per row step for N <= 32, 1 << (v - 1) is built through the float exponent
+//     N > 64 (uint8_t or uint16_t cells), a mask of several 32-bit words per column kept in memory
+//         AVX-512 - 16 columns at a time: word index and bit of every lane computed together, then the
+//                   words are gathered, or'ed and scattered back in one go
+//         AVX2    - the same word index and bit computation, the 16 or's are then done one by one
+//       the lanes of one step are 16 different columns, so their words never collide.
+// everything else goes through the scalar engine. all engines handle up to SUDOKU_COL_BLOCK columns at
+// a time so each row step of a large grid still reads whole cache lines, and keep their masks in a
+// SUDOKU_COL_MASK_BYTES buffer on the stack; fewer columns are taken at a time when N is so large that
+// SUDOKU_COL_BLOCK masks do not fit. nothing is allocated per call.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "sudoku_check.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define SUDOKU_COLS_X86 1
+#endif
+
+#define SUDOKU_COL_BLOCK 64             // columns kept in flight at most
+#define SUDOKU_COL_MASK_BYTES 32768     // stack space for the masks of those columns
+
+typedef enum
+    {
+        COL_ENGINE_AUTO,        // best engine the cpu supports
+        COL_ENGINE_SCALAR,
+        COL_ENGINE_SSE42,
+        COL_ENGINE_AVX2,
+        COL_ENGINE_AVX512
+
+    } col_engine;
+
+static inline const char *col_engine_name(col_engine engine)
+    {
+        switch (engine)
+            {
+                case COL_ENGINE_SCALAR: return "scalar";
+                case COL_ENGINE_SSE42: return "sse4.2";
+                case COL_ENGINE_AVX2: return "avx2";
+                case COL_ENGINE_AVX512: return "avx512";
+                default: return "auto";
+            }
+    }
+
+static inline col_engine col_engine_detect(void)
+    {
+        // picks the widest vector path this cpu can run
+
+#ifdef SUDOKU_COLS_X86
+        __builtin_cpu_init();
+
+        if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx2"))
+            {
+                return COL_ENGINE_AVX512;
+            }
+
+        if (__builtin_cpu_supports("avx2"))
+            {
+                return COL_ENGINE_AVX2;
+            }
+
+        if (__builtin_cpu_supports("sse4.2"))
+            {
+                return COL_ENGINE_SSE42;
+            }
+#endif
+
+        return COL_ENGINE_SCALAR;
+    }
+
+// scalar engine, for every cell width. validates the columns first, first + step, ... below 'last' and
+// writes the k-th verdict to col_valid[k].
+
+#define SUDOKU_DEFINE_COLS_SCALAR(name, cell_t, row_at)                                                 \
+static inline void name(const sudoku_grid *grid, int first, int last, int step, bool *col_valid)        \
+    {                                                                                                   \
+        int size = grid->size;                                                                          \
+        int count = (last - first + step - 1) / step;                                                   \
+        int words = digit_set_words(size);                                                              \
+                                                                                                        \
+        uint64_t masks[SUDOKU_COL_MASK_BYTES / sizeof(uint64_t)];                                       \
+        int max_block = (int)(sizeof(masks) / sizeof(uint64_t)) / words;                                \
+        max_block = (max_block < SUDOKU_COL_BLOCK) ? max_block : SUDOKU_COL_BLOCK;                      \
+                                                                                                        \
+        for (int k0 = 0; k0 < count; k0 += max_block)                                                   \
+            {                                                                                           \
+                int block = (count - k0 < max_block) ? count - k0 : max_block;                          \
+                int col0 = first + k0 * step;                                                           \
+                                                                                                        \
+                memset(masks, 0, sizeof(uint64_t) * block * words);                                     \
+                                                                                                        \
+                for (int r = 0; r < size; r++)                                                          \
+                    {                                                                                   \
+                        const cell_t *cells = row_at(grid, r) + col0;                                   \
+                                                                                                        \
+                        if (words == 1)                                                                 \
+                            {                                                                           \
+                                for (int k = 0; k < block; k++)                                         \
+                                    {                                                                   \
+                                        masks[k] |= digit_bit(size, cells[k * step]);                   \
+                                    }                                                                   \
+                            }                                                                           \
+                                                                                                        \
+                        else                                                                            \
+                            {                                                                           \
+                                for (int k = 0; k < block; k++)                                         \
+                                    {                                                                   \
+                                        digit_words_add(masks + k * words, size, cells[k * step]);      \
+                                    }                                                                   \
+                            }                                                                           \
+                    }                                                                                   \
+                                                                                                        \
+                for (int k = 0; k < block; k++)                                                         \
+                    {                                                                                   \
+                        col_valid[k0 + k] = digit_words_full(masks + k * words, size);                  \
+                    }                                                                                   \
+            }                                                                                           \
+    }
+
+SUDOKU_DEFINE_COLS_SCALAR(sudoku_cols_scalar_u8, uint8_t, sudoku_grid_row8)
+SUDOKU_DEFINE_COLS_SCALAR(sudoku_cols_scalar_u16, uint16_t, sudoku_grid_row16)
+
+#ifdef SUDOKU_COLS_X86
+
+// the vector paths work on groups that start at a multiple of the group width. they only run on grids
+// whose rows are padded to a whole cache line, so a group never reads past its row, and padding cells
+// (0) are never reported.
+
+static inline uint32_t sudoku_cols_load4(const uint8_t *cells)
+    {
+        uint32_t four;
+        memcpy(&four, cells, sizeof(four));
+        return four;
+    }
+
+__attribute__((target("avx2")))
+static inline void sudoku_cols_avx2_32(const sudoku_grid *grid, int first, int last, bool *col_valid)
+    {
+        // N <= 32: one 32-bit mask per column, 8 columns per register, 32 columns per row step
+
+        const __m256i one = _mm256_set1_epi32(1);
+        uint32_t full = (uint32_t)digit_mask_full(grid->size);
+
+        for (int base = first & ~31; base < last; base += 32)
+            {
+                __m256i acc0 = _mm256_setzero_si256(), acc1 = acc0, acc2 = acc0, acc3 = acc0;
+
+                for (int r = 0; r < grid->size; r++)
+                    {
+                        const uint8_t *cells = sudoku_grid_row8(grid, r) + base;
+
+                        __m256i v0 = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(cells)));
+                        __m256i v1 = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(cells + 8)));
+                        __m256i v2 = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(cells + 16)));
+                        __m256i v3 = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(cells + 24)));
+
+                        // a 0 cell becomes a shift of 0xffffffff, which sllv turns into an empty bit
+                        acc0 = _mm256_or_si256(acc0, _mm256_sllv_epi32(one, _mm256_sub_epi32(v0, one)));
+                        acc1 = _mm256_or_si256(acc1, _mm256_sllv_epi32(one, _mm256_sub_epi32(v1, one)));
+                        acc2 = _mm256_or_si256(acc2, _mm256_sllv_epi32(one, _mm256_sub_epi32(v2, one)));
+                        acc3 = _mm256_or_si256(acc3, _mm256_sllv_epi32(one, _mm256_sub_epi32(v3, one)));
+                    }
+
+                uint32_t masks[32];
+                _mm256_storeu_si256((__m256i *)(masks), acc0);
+                _mm256_storeu_si256((__m256i *)(masks + 8), acc1);
+                _mm256_storeu_si256((__m256i *)(masks + 16), acc2);
+                _mm256_storeu_si256((__m256i *)(masks + 24), acc3);
+
+                for (int k = 0; k < 32; k++)
+                    {
+                        int col = base + k;
+
+                        if (col >= first && col < last)
+                            {
+                                col_valid[col - first] = (masks[k] == full);
+                            }
+                    }
+            }
+    }
+
+__attribute__((target("avx2")))
+static inline void sudoku_cols_avx2_64(const sudoku_grid *grid, int first, int last, bool *col_valid)
+    {
+        // N <= 64: one 64-bit mask per column, 4 columns per register, 16 columns per row step
+
+        const __m256i one = _mm256_set1_epi64x(1);
+        uint64_t full = digit_mask_full(grid->size);
+
+        for (int base = first & ~15; base < last; base += 16)
+            {
+                __m256i acc0 = _mm256_setzero_si256(), acc1 = acc0, acc2 = acc0, acc3 = acc0;
+
+                for (int r = 0; r < grid->size; r++)
+                    {
+                        const uint8_t *cells = sudoku_grid_row8(grid, r) + base;
+
+                        __m256i v0 = _mm256_cvtepu8_epi64(_mm_cvtsi32_si128((int)sudoku_cols_load4(cells)));
+                        __m256i v1 = _mm256_cvtepu8_epi64(_mm_cvtsi32_si128((int)sudoku_cols_load4(cells + 4)));
+                        __m256i v2 = _mm256_cvtepu8_epi64(_mm_cvtsi32_si128((int)sudoku_cols_load4(cells + 8)));
+                        __m256i v3 = _mm256_cvtepu8_epi64(_mm_cvtsi32_si128((int)sudoku_cols_load4(cells + 12)));
+
+                        acc0 = _mm256_or_si256(acc0, _mm256_sllv_epi64(one, _mm256_sub_epi64(v0, one)));
+                        acc1 = _mm256_or_si256(acc1, _mm256_sllv_epi64(one, _mm256_sub_epi64(v1, one)));
+                        acc2 = _mm256_or_si256(acc2, _mm256_sllv_epi64(one, _mm256_sub_epi64(v2, one)));
+                        acc3 = _mm256_or_si256(acc3, _mm256_sllv_epi64(one, _mm256_sub_epi64(v3, one)));
+                    }
+
+                uint64_t masks[16];
+                _mm256_storeu_si256((__m256i *)(masks), acc0);
+                _mm256_storeu_si256((__m256i *)(masks + 4), acc1);
+                _mm256_storeu_si256((__m256i *)(masks + 8), acc2);
+                _mm256_storeu_si256((__m256i *)(masks + 12), acc3);
+
+                for (int k = 0; k < 16; k++)
+                    {
+                        int col = base + k;
+
+                        if (col >= first && col < last)
+                            {
+                                col_valid[col - first] = (masks[k] == full);
+                            }
+                    }
+            }
+    }
+
+__attribute__((target("sse4.2")))
+static inline void sudoku_cols_sse42_32(const sudoku_grid *grid, int first, int last, bool *col_valid)
+    {
+        // N <= 32: SSE has no per lane shift, so 1 << (v - 1) is made as the float 2^(v - 1) by writing
+        // v + 126 into the exponent and truncating back to an integer. v = 0 gives 0.5 which truncates to
+        // 0, and v = 32 gives 2^31 which truncates to 0x80000000, exactly bit 31. anything above N (only
+        // possible in a mapped grid) would overflow to that same bit, so those lanes are masked off.
+
+        const __m128i bias = _mm_set1_epi32(126);
+        const __m128i size = _mm_set1_epi32(grid->size);
+        uint32_t full = (uint32_t)digit_mask_full(grid->size);
+
+        for (int base = first & ~15; base < last; base += 16)
+            {
+                __m128i acc0 = _mm_setzero_si128(), acc1 = acc0, acc2 = acc0, acc3 = acc0;
+
+                for (int r = 0; r < grid->size; r++)
+                    {
+                        const uint8_t *cells = sudoku_grid_row8(grid, r) + base;
+
+                        __m128i v0 = _mm_cvtepu8_epi32(_mm_cvtsi32_si128((int)sudoku_cols_load4(cells)));
+                        __m128i v1 = _mm_cvtepu8_epi32(_mm_cvtsi32_si128((int)sudoku_cols_load4(cells + 4)));
+                        __m128i v2 = _mm_cvtepu8_epi32(_mm_cvtsi32_si128((int)sudoku_cols_load4(cells + 8)));
+                        __m128i v3 = _mm_cvtepu8_epi32(_mm_cvtsi32_si128((int)sudoku_cols_load4(cells + 12)));
+
+                        acc0 = _mm_or_si128(acc0, _mm_andnot_si128(_mm_cmpgt_epi32(v0, size), _mm_cvttps_epi32(_mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(v0, bias), 23)))));
+                        acc1 = _mm_or_si128(acc1, _mm_andnot_si128(_mm_cmpgt_epi32(v1, size), _mm_cvttps_epi32(_mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(v1, bias), 23)))));
+                        acc2 = _mm_or_si128(acc2, _mm_andnot_si128(_mm_cmpgt_epi32(v2, size), _mm_cvttps_epi32(_mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(v2, bias), 23)))));
+                        acc3 = _mm_or_si128(acc3, _mm_andnot_si128(_mm_cmpgt_epi32(v3, size), _mm_cvttps_epi32(_mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(v3, bias), 23)))));
+                    }
+
+                uint32_t masks[16];
+                _mm_storeu_si128((__m128i *)(masks), acc0);
+                _mm_storeu_si128((__m128i *)(masks + 4), acc1);
+                _mm_storeu_si128((__m128i *)(masks + 8), acc2);
+                _mm_storeu_si128((__m128i *)(masks + 12), acc3);
+
+                for (int k = 0; k < 16; k++)
+                    {
+                        int col = base + k;
+
+                        if (col >= first && col < last)
+                            {
+                                col_valid[col - first] = (masks[k] == full);
+                            }
+                    }
+            }
+    }
+
+// N > 64: a mask of 'words' 32-bit words per column, kept in a stack buffer. the columns go in groups of
+// 16 that start at a multiple of 16, so with padded rows a group load never leaves its row.
+
+static inline int sudoku_cols_wide_block(int size)
+    {
+        // columns per block: as many groups of 16 as the stack buffer holds, 0 when not even one fits
+
+        int words = (size + 31) >> 5;
+        int block = ((int)(SUDOKU_COL_MASK_BYTES / sizeof(uint32_t)) / words) & ~15;
+
+        return (block < SUDOKU_COL_BLOCK) ? block : SUDOKU_COL_BLOCK;
+    }
+
+static inline void sudoku_cols_wide_verdicts(const uint32_t *masks, int size, int base, int block, int first, int last, bool *col_valid)
+    {
+        int words = (size + 31) >> 5;
+        uint32_t full_tail = (size % 32) ? ((uint32_t)1 << (size % 32)) - 1 : 0xffffffffu;
+
+        for (int k = 0; k < block; k++)
+            {
+                int col = base + k;
+
+                if (col < first || col >= last)
+                    {
+                        continue;
+                    }
+
+                const uint32_t *mask = masks + k * words;
+                uint32_t missing = mask[words - 1] ^ full_tail;
+
+                for (int w = 0; w + 1 < words; w++)
+                    {
+                        missing |= ~mask[w];
+                    }
+
+                col_valid[col - first] = (missing == 0);
+            }
+    }
+
+__attribute__((target("avx2")))
+static inline void sudoku_cols_avx2_load16(const sudoku_grid *grid, int r, int col, __m256i *low, __m256i *high)
+    {
+        // 16 cells of either width, widened to 32-bit lanes
+
+        if (grid->cell_bytes == 1)
+            {
+                const uint8_t *cells = sudoku_grid_row8(grid, r) + col;
+                *low = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(cells)));
+                *high = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(cells + 8)));
+            }
+
+        else
+            {
+                const uint16_t *cells = sudoku_grid_row16(grid, r) + col;
+                *low = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)(cells)));
+                *high = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)(cells + 8)));
+            }
+    }
+
+__attribute__((target("avx2")))
+static inline void sudoku_cols_avx2_wide(const sudoku_grid *grid, int first, int last, bool *col_valid)
+    {
+        // N > 64: the word offset and bit of 16 columns are worked out in two registers, AVX2 has no
+        // scatter so the 16 or's into the masks are then done one by one. i = v - 1 is compared as
+        // unsigned, so a 0 cell (i wraps around) and anything above N add an empty bit to the lane's
+        // first word.
+
+        int size = grid->size;
+        int words = (size + 31) >> 5;
+        int block = sudoku_cols_wide_block(size);
+        uint32_t masks[SUDOKU_COL_MASK_BYTES / sizeof(uint32_t)];
+
+        const __m256i one = _mm256_set1_epi32(1);
+        const __m256i low_bits = _mm256_set1_epi32(31);
+        const __m256i top = _mm256_set1_epi32(size - 1);
+        const __m256i lane_low = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(words));
+        const __m256i lane_high = _mm256_add_epi32(lane_low, _mm256_set1_epi32(8 * words));
+
+        for (int base = first & ~15; base < last; base += block)
+            {
+                int groups = (last - base + 15) >> 4;
+                groups = (groups < block / 16) ? groups : block / 16;
+
+                memset(masks, 0, sizeof(uint32_t) * groups * 16 * words);
+
+                for (int r = 0; r < size; r++)
+                    {
+                        for (int g = 0; g < groups; g++)
+                            {
+                                uint32_t *group = masks + g * 16 * words;
+                                __m256i i0, i1;
+
+                                sudoku_cols_avx2_load16(grid, r, base + g * 16, &i0, &i1);
+                                i0 = _mm256_sub_epi32(i0, one);
+                                i1 = _mm256_sub_epi32(i1, one);
+
+                                __m256i ok0 = _mm256_cmpeq_epi32(_mm256_min_epu32(i0, top), i0);
+                                __m256i ok1 = _mm256_cmpeq_epi32(_mm256_min_epu32(i1, top), i1);
+
+                                uint32_t offset[16], bit[16];
+                                _mm256_storeu_si256((__m256i *)(offset), _mm256_add_epi32(lane_low, _mm256_and_si256(_mm256_srli_epi32(i0, 5), ok0)));
+                                _mm256_storeu_si256((__m256i *)(offset + 8), _mm256_add_epi32(lane_high, _mm256_and_si256(_mm256_srli_epi32(i1, 5), ok1)));
+                                _mm256_storeu_si256((__m256i *)(bit), _mm256_and_si256(_mm256_sllv_epi32(one, _mm256_and_si256(i0, low_bits)), ok0));
+                                _mm256_storeu_si256((__m256i *)(bit + 8), _mm256_and_si256(_mm256_sllv_epi32(one, _mm256_and_si256(i1, low_bits)), ok1));
+
+                                for (int k = 0; k < 16; k++)
+                                    {
+                                        group[offset[k]] |= bit[k];
+                                    }
+                            }
+                    }
+
+                sudoku_cols_wide_verdicts(masks, size, base, groups * 16, first, last, col_valid);
+            }
+    }
+
+__attribute__((target("avx512f")))
+static inline __m512i sudoku_cols_avx512_load16(const sudoku_grid *grid, int r, int col)
+    {
+        // the zero masking forms throughout give the same instructions, but keep g++ 12 from warning
+        // about the undefined source register of the plain ones
+
+        if (grid->cell_bytes == 1)
+            {
+                return _mm512_maskz_cvtepu8_epi32(0xffff, _mm_loadu_si128((const __m128i *)(sudoku_grid_row8(grid, r) + col)));
+            }
+
+        return _mm512_maskz_cvtepu16_epi32(0xffff, _mm256_loadu_si256((const __m256i *)(sudoku_grid_row16(grid, r) + col)));
+    }
+
+__attribute__((target("avx512f")))
+static inline void sudoku_cols_avx512_wide(const sudoku_grid *grid, int first, int last, bool *col_valid)
+    {
+        // N > 64: the same offsets and bits in one register, then one gather, or and scatter per 16
+        // columns. lanes whose cell is 0 or above N are masked off the gather and the scatter.
+
+        int size = grid->size;
+        int words = (size + 31) >> 5;
+        int block = sudoku_cols_wide_block(size);
+        uint32_t masks[SUDOKU_COL_MASK_BYTES / sizeof(uint32_t)];
+
+        const __m512i one = _mm512_set1_epi32(1);
+        const __m512i low_bits = _mm512_set1_epi32(31);
+        const __m512i n = _mm512_set1_epi32(size);
+        const __m512i lane = _mm512_mullo_epi32(_mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15), _mm512_set1_epi32(words));
+
+        for (int base = first & ~15; base < last; base += block)
+            {
+                int groups = (last - base + 15) >> 4;
+                groups = (groups < block / 16) ? groups : block / 16;
+
+                memset(masks, 0, sizeof(uint32_t) * groups * 16 * words);
+
+                for (int r = 0; r < size; r++)
+                    {
+                        for (int g = 0; g < groups; g++)
+                            {
+                                uint32_t *group = masks + g * 16 * words;
+                                __m512i i = _mm512_sub_epi32(sudoku_cols_avx512_load16(grid, r, base + g * 16), one);
+                                __mmask16 ok = _mm512_cmplt_epu32_mask(i, n);
+
+                                __m512i offset = _mm512_add_epi32(lane, _mm512_maskz_srli_epi32(ok, i, 5));
+                                __m512i bit = _mm512_maskz_sllv_epi32(ok, one, _mm512_and_si512(i, low_bits));
+                                __m512i word = _mm512_mask_i32gather_epi32(_mm512_setzero_si512(), ok, offset, group, 4);
+
+                                _mm512_mask_i32scatter_epi32(group, ok, offset, _mm512_or_si512(word, bit), 4);
+                            }
+                    }
+
+                sudoku_cols_wide_verdicts(masks, size, base, groups * 16, first, last, col_valid);
+            }
+    }
+
+#endif
+
+static inline col_engine col_engine_used(col_engine engine, const sudoku_grid *grid, int step)
+    {
+        // the engine sudoku_check_cols_step_with really runs for this grid and step: vector paths only
+        // take contiguous runs of a padded grid, N <= 64 runs the register paths (AVX-512 has none of
+        // its own there), SSE4.2 stops at N = 32, and a mask too large for the stack buffer is scalar
+
+#ifdef SUDOKU_COLS_X86
+        if (engine == COL_ENGINE_AUTO)
+            {
+                engine = col_engine_detect();
+            }
+
+        bool padded = (grid->stride * grid->cell_bytes) % SUDOKU_GRID_ALIGN == 0;
+
+        if (step != 1 || !padded)
+            {
+                return COL_ENGINE_SCALAR;
+            }
+
+        if (grid->size <= 64 && grid->cell_bytes == 1)
+            {
+                if (engine == COL_ENGINE_AVX512 || engine == COL_ENGINE_AVX2)
+                    {
+                        return COL_ENGINE_AVX2;
+                    }
+
+                return (engine == COL_ENGINE_SSE42 && grid->size <= 32) ? COL_ENGINE_SSE42 : COL_ENGINE_SCALAR;
+            }
+
+        if ((engine == COL_ENGINE_AVX512 || engine == COL_ENGINE_AVX2) && sudoku_cols_wide_block(grid->size) > 0)
+            {
+                return engine;
+            }
+#else
+        (void)engine;
+        (void)grid;
+        (void)step;
+#endif
+
+        return COL_ENGINE_SCALAR;
+    }
+
+static inline void sudoku_check_cols_step_with(col_engine engine, const sudoku_grid *grid, int first, int last, int step, bool *col_valid)
+    {
+        // validates columns first, first + step, ... below 'last'; the k-th verdict goes to col_valid[k]
+
+        if (first >= last)
+            {
+                return;
+            }
+
+#ifdef SUDOKU_COLS_X86
+        bool small = (grid->size <= 64 && grid->cell_bytes == 1);
+
+        switch (col_engine_used(engine, grid, step))
+            {
+                case COL_ENGINE_AVX512:
+                    sudoku_cols_avx512_wide(grid, first, last, col_valid);
+                    return;
+
+                case COL_ENGINE_AVX2:
+                    if (!small)
+                        {
+                            sudoku_cols_avx2_wide(grid, first, last, col_valid);
+                        }
+
+                    else if (grid->size <= 32)
+                        {
+                            sudoku_cols_avx2_32(grid, first, last, col_valid);
+                        }
+
+                    else
+                        {
+                            sudoku_cols_avx2_64(grid, first, last, col_valid);
+                        }
+
+                    return;
+
+                case COL_ENGINE_SSE42:
+                    sudoku_cols_sse42_32(grid, first, last, col_valid);
+                    return;
+
+                default:
+                    break;
+            }
+#else
+        (void)engine;
+#endif
+
+        if (grid->cell_bytes == 1)
+            {
+                sudoku_cols_scalar_u8(grid, first, last, step, col_valid);
+            }
+
+        else
+            {
+                sudoku_cols_scalar_u16(grid, first, last, step, col_valid);
+            }
+    }
+
+static inline void sudoku_check_cols_step(const sudoku_grid *grid, int first, int last, int step, bool *col_valid)
+    {
+        sudoku_check_cols_step_with(COL_ENGINE_AUTO, grid, first, last, step, col_valid);
+    }
+
+static inline void sudoku_check_cols(const sudoku_grid *grid, int first, int last, bool *col_valid)
+    {
+        // validates the contiguous columns [first, last); col_valid[c - first] is the verdict of column c
+
+        sudoku_check_cols_step_with(COL_ENGINE_AUTO, grid, first, last, 1, col_valid);
+    }
+
+#endif
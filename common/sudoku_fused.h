@@ -0,0 +1,347 @@
+#ifndef SUDOKU_FUSED_H
+#define SUDOKU_FUSED_H
+
+// single pass validation.
+//
+// checking rows, columns and subgrids separately reads the grid three times. the fused validator
+// reads every cell once and sets its bit in the row mask, the column mask and the subgrid mask in the
+// same step.
+//
+// the parallel version splits the grid into bands of whole rows. rows are complete inside a band;
+// column masks and the masks of subgrids that cross a band edge are OR-merged into shared masks once a
+// band is done. a merged mask with all N bits set is still proof of no repeats, since a column or
+// subgrid has exactly N cells in total.
+//
+// a band stops at its first invalid row, and the bands of one grid share a flag so that the others
+// stop at their next row too. the result is invalid either way, so the unfinished masks do not matter.
+//
+// the single band entry points do not allocate: sudoku_check_fused_masks works in masks the caller
+// keeps between puzzles, and sudoku_check_fused keeps them on the stack up to SUDOKU_FUSED_STACK_WORDS.
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sudoku_check.h"
+#include "thread_pool.h"
+
+#define SUDOKU_FUSED_STACK_WORDS 2048   // column and subgrid masks kept on the stack, enough for N = 256
+
+typedef struct
+    {
+        // one band of rows and where its masks go
+
+        const sudoku_grid *grid;
+        int first_row;          // rows [first_row, last_row) belong to this band
+        int last_row;
+
+        uint64_t *cols;         // shared column masks, size x words
+        uint64_t *boxes;        // shared subgrid masks, size x words, subgrid b is row b / n, column b % n
+        bool merge;             // OR the band masks into the shared ones atomically (more than one band)
+        int *stop;              // shared flag, set once any band finds an invalid row (NULL for one band)
+
+        bool rows_valid;        // output: every row of the band is valid
+
+    } fused_band;
+
+#define SUDOKU_DEFINE_FUSED_BAND(name, cell_t, row_at)                                                  \
+static inline bool name(const fused_band *band, uint64_t *cols, uint64_t *boxes, int first_box_row)     \
+    {                                                                                                   \
+        /* accumulates the band into cols (size x words) and boxes (band subgrids x words, counted */   \
+        /* from subgrid row first_box_row). returns whether every row of the band is valid. */          \
+                                                                                                        \
+        const sudoku_grid *grid = band->grid;                                                           \
+        int size = grid->size;                                                                          \
+        int n = sudoku_box_size(size);                                                                  \
+        int words = digit_set_words(size);                                                              \
+        bool rows_valid = true;                                                                         \
+                                                                                                        \
+        for (int r = band->first_row; r < band->last_row; r++)                                          \
+            {                                                                                           \
+                if (!rows_valid || (band->stop && __atomic_load_n(band->stop, __ATOMIC_RELAXED)))       \
+                    {                                                                                   \
+                        break;                                                                          \
+                    }                                                                                   \
+                                                                                                        \
+                const cell_t *cells = row_at(grid, r);                                                  \
+                uint64_t *box_row = boxes + (size_t)(r / n - first_box_row) * n * words;                \
+                                                                                                        \
+                if (words == 1)                                                                         \
+                    {                                                                                   \
+                        uint64_t seen = 0;                                                              \
+                                                                                                        \
+                        for (int bc = 0, c = 0; bc < n; bc++)                                           \
+                            {                                                                           \
+                                uint64_t box = 0;                                                       \
+                                                                                                        \
+                                for (int j = 0; j < n; j++, c++)                                        \
+                                    {                                                                   \
+                                        uint64_t bit = digit_bit(size, cells[c]);                       \
+                                        seen |= bit;                                                    \
+                                        box |= bit;                                                     \
+                                        cols[c] |= bit;                                                 \
+                                    }                                                                   \
+                                                                                                        \
+                                box_row[bc] |= box;                                                     \
+                            }                                                                           \
+                                                                                                        \
+                        rows_valid &= (seen == digit_mask_full(size));                                  \
+                        continue;                                                                       \
+                    }                                                                                   \
+                                                                                                        \
+                digit_set seen;                                                                         \
+                digit_set_clear(&seen, size);                                                           \
+                                                                                                        \
+                for (int bc = 0, c = 0; bc < n; bc++)                                                   \
+                    {                                                                                   \
+                        uint64_t *box = box_row + (size_t)bc * words;                                   \
+                                                                                                        \
+                        for (int j = 0; j < n; j++, c++)                                                \
+                            {                                                                           \
+                                unsigned idx = (unsigned)(cells[c] - 1);                                \
+                                uint64_t in_range = (uint64_t)0 - (uint64_t)(idx < (unsigned)size);     \
+                                unsigned word = (idx >> 6) & (unsigned)in_range;                        \
+                                uint64_t bit = ((uint64_t)1 << (idx & 63)) & in_range;                  \
+                                                                                                        \
+                                seen.words[word] |= bit;                                                \
+                                box[word] |= bit;                                                       \
+                                cols[(size_t)c * words + word] |= bit;                                  \
+                            }                                                                           \
+                    }                                                                                   \
+                                                                                                        \
+                rows_valid &= digit_set_full(&seen, size);                                              \
+            }                                                                                           \
+                                                                                                        \
+        return rows_valid;                                                                              \
+    }
+
+SUDOKU_DEFINE_FUSED_BAND(sudoku_fused_band_u8, uint8_t, sudoku_grid_row8)
+SUDOKU_DEFINE_FUSED_BAND(sudoku_fused_band_u16, uint16_t, sudoku_grid_row16)
+
+static inline void *sudoku_fused_band_run(void *param)
+    {
+        // validates one band. with merge set, the band works on private masks and ORs them into the
+        // shared ones at the end; otherwise it writes the shared masks directly.
+
+        fused_band *band = (fused_band *)param;
+        const sudoku_grid *grid = band->grid;
+        int size = grid->size;
+        int n = sudoku_box_size(size);
+        int words = digit_set_words(size);
+
+        band->rows_valid = true;
+
+        if (band->first_row >= band->last_row)
+            {
+                return NULL;
+            }
+
+        int first_box_row = band->first_row / n;
+        int box_rows = (band->last_row - 1) / n - first_box_row + 1;
+
+        uint64_t *cols = band->cols;
+        uint64_t *boxes = band->boxes + (size_t)first_box_row * n * words;
+
+        if (band->merge)
+            {
+                cols = (uint64_t *)calloc((size_t)size * words, sizeof(uint64_t));
+                boxes = (uint64_t *)calloc((size_t)box_rows * n * words, sizeof(uint64_t));
+
+                if (cols == NULL || boxes == NULL)
+                    {
+                        free(cols);
+                        free(boxes);
+                        band->rows_valid = false;
+                        return NULL;
+                    }
+            }
+
+        if (grid->cell_bytes == 1)
+            {
+                band->rows_valid = sudoku_fused_band_u8(band, cols, boxes, first_box_row);
+            }
+
+        else
+            {
+                band->rows_valid = sudoku_fused_band_u16(band, cols, boxes, first_box_row);
+            }
+
+        if (!band->rows_valid && band->stop != NULL)
+            {
+                __atomic_store_n(band->stop, 1, __ATOMIC_RELAXED);
+            }
+
+        if (band->merge)
+            {
+                uint64_t *shared_boxes = band->boxes + (size_t)first_box_row * n * words;
+
+                for (size_t i = 0; i < (size_t)size * words; i++)
+                    {
+                        __atomic_fetch_or(&band->cols[i], cols[i], __ATOMIC_RELAXED);
+                    }
+
+                for (size_t i = 0; i < (size_t)box_rows * n * words; i++)
+                    {
+                        __atomic_fetch_or(&shared_boxes[i], boxes[i], __ATOMIC_RELAXED);
+                    }
+
+                free(cols);
+                free(boxes);
+            }
+
+        return NULL;
+    }
+
+static inline bool sudoku_fused_masks_full(const uint64_t *masks, int size)
+    {
+        // true if all 'size' masks (columns or subgrids) have every number
+
+        int words = digit_set_words(size);
+        bool full = true;
+
+        for (int i = 0; i < size; i++)
+            {
+                full &= digit_words_full(masks + (size_t)i * words, size);
+            }
+
+        return full;
+    }
+
+static inline bool sudoku_check_fused_masks(const sudoku_grid *grid, uint64_t *cols, uint64_t *boxes)
+    {
+        // validates the whole sudoku in one pass on the calling thread, in the caller's cols and boxes
+        // (size x digit_set_words(size) words each, cleared here). nothing is allocated, so a caller
+        // that validates many puzzles keeps the two buffers from one puzzle to the next.
+
+        int size = grid->size;
+        int n = sudoku_box_size(size);
+        size_t words = (size_t)size * digit_set_words(size);
+
+        if (n * n != size)
+            {
+                return false;
+            }
+
+        memset(cols, 0, words * sizeof(uint64_t));
+        memset(boxes, 0, words * sizeof(uint64_t));
+
+        fused_band band = {grid, 0, size, cols, boxes, false, NULL, true};
+        bool rows_valid = (grid->cell_bytes == 1) ? sudoku_fused_band_u8(&band, cols, boxes, 0) : sudoku_fused_band_u16(&band, cols, boxes, 0);
+
+        return rows_valid && sudoku_fused_masks_full(cols, size) && sudoku_fused_masks_full(boxes, size);
+    }
+
+static inline bool sudoku_check_fused(const sudoku_grid *grid)
+    {
+        // validates the whole sudoku in one pass on the calling thread. the masks are on the stack unless
+        // the grid is too large for SUDOKU_FUSED_STACK_WORDS.
+
+        uint64_t masks[SUDOKU_FUSED_STACK_WORDS];
+        size_t words = (size_t)grid->size * digit_set_words(grid->size);
+
+        if (2 * words <= SUDOKU_FUSED_STACK_WORDS)
+            {
+                return sudoku_check_fused_masks(grid, masks, masks + words);
+            }
+
+        uint64_t *heap = (uint64_t *)malloc(2 * words * sizeof(uint64_t));
+
+        if (heap == NULL)
+            {
+                return false;
+            }
+
+        bool validity = sudoku_check_fused_masks(grid, heap, heap + words);
+
+        free(heap);
+        return validity;
+    }
+
+static inline bool sudoku_check_fused_parallel(const sudoku_grid *grid, int no_of_threads, thread_pool *pool)
+    {
+        // validates the whole sudoku in one pass split over no_of_threads bands of rows. the bands run as
+        // tasks on 'pool', or on their own threads when pool is NULL. no_of_threads <= 1 is
+        // sudoku_check_fused on the calling thread.
+
+        int size = grid->size;
+        int n = sudoku_box_size(size);
+        int words = digit_set_words(size);
+
+        if (n * n != size)
+            {
+                return false;
+            }
+
+        if (no_of_threads > size)
+            {
+                no_of_threads = size;
+            }
+
+        if (no_of_threads <= 1)
+            {
+                return sudoku_check_fused(grid);
+            }
+
+        uint64_t *cols = (uint64_t *)calloc((size_t)size * words, sizeof(uint64_t));
+        uint64_t *boxes = (uint64_t *)calloc((size_t)size * words, sizeof(uint64_t));
+        fused_band *bands = (fused_band *)malloc(no_of_threads * sizeof(fused_band));
+        pthread_t *t_ids = (pthread_t *)malloc(no_of_threads * sizeof(pthread_t));
+
+        bool validity = (cols != NULL && boxes != NULL && bands != NULL && t_ids != NULL);
+        int stop = 0;
+        int chunk_size = size / no_of_threads;
+
+        for (int i = 0; validity && i < no_of_threads; i++)
+            {
+                // bands are cut like the chunk method, the last band takes the leftover rows
+
+                bands[i].grid = grid;
+                bands[i].first_row = i * chunk_size;
+                bands[i].last_row = (i == no_of_threads - 1) ? size : (i + 1) * chunk_size;
+                bands[i].cols = cols;
+                bands[i].boxes = boxes;
+                bands[i].merge = true;
+                bands[i].stop = &stop;
+
+                if (pool != NULL)
+                    {
+                        thread_pool_submit(pool, sudoku_fused_band_run, &bands[i]);
+                    }
+
+                else
+                    {
+                        pthread_create(&t_ids[i], NULL, sudoku_fused_band_run, &bands[i]);
+                    }
+            }
+
+        if (validity && pool != NULL)
+            {
+                thread_pool_wait(pool);
+            }
+
+        for (int i = 0; validity && pool == NULL && i < no_of_threads; i++)
+            {
+                pthread_join(t_ids[i], NULL);
+            }
+
+        for (int i = 0; validity && i < no_of_threads; i++)
+            {
+                validity &= bands[i].rows_valid;
+            }
+
+        if (validity)
+            {
+                validity = sudoku_fused_masks_full(cols, size) && sudoku_fused_masks_full(boxes, size);
+            }
+
+        free(cols);
+        free(boxes);
+        free(bands);
+        free(t_ids);
+
+        return validity;
+    }
+
+#endif
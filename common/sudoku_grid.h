@@ -0,0 +1,152 @@
+#ifndef SUDOKU_GRID_H
+#define SUDOKU_GRID_H
+
+// flat storage for an N x N sudoku shared by the Assignment1 and Assignment2 programs.
+//
+// all cells live in one 64 byte aligned block, row major, with every row padded to a whole number of
+// cache lines. cells are uint8_t when N <= 255 and uint16_t above that, so a 1024 x 1024 grid takes
+// 2 MB instead of N separately allocated int rows.
+// a value outside 1..N is stored as 0, which the check kernels treat as invalid.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SUDOKU_GRID_ALIGN 64            // alignment of the block and of every row, in bytes
+#define SUDOKU_GRID_MAX_SIZE 65535      // largest N a uint16_t cell can hold
+
+typedef struct
+    {
+        int size;          // dimension(Row/Column)
+        int cell_bytes;    // 1 => uint8_t cells, 2 => uint16_t cells
+        size_t stride;     // cells from the start of one row to the next (includes padding)
+        void *cells;       // the block itself
+        bool view;         // cells belong to someone else (e.g. a mapped file) and are never freed here
+
+    } sudoku_grid;
+
+static inline bool sudoku_grid_init(sudoku_grid *grid, int size)
+    {
+        // allocates a zero filled grid for an N x N sudoku. returns false if N is out of range or the
+        // allocation fails.
+
+        grid->size = 0;
+        grid->cell_bytes = 1;
+        grid->stride = 0;
+        grid->cells = NULL;
+        grid->view = false;
+
+        if (size <= 0 || size > SUDOKU_GRID_MAX_SIZE)
+            {
+                return false;
+            }
+
+        int cell_bytes = (size <= 255) ? 1 : 2;
+        size_t row_bytes = (size_t)size * cell_bytes;
+        row_bytes = (row_bytes + SUDOKU_GRID_ALIGN - 1) & ~(size_t)(SUDOKU_GRID_ALIGN - 1);
+
+        void *cells = NULL;
+
+        if (posix_memalign(&cells, SUDOKU_GRID_ALIGN, row_bytes * size) != 0)
+            {
+                return false;
+            }
+
+        memset(cells, 0, row_bytes * size);
+
+        grid->size = size;
+        grid->cell_bytes = cell_bytes;
+        grid->stride = row_bytes / cell_bytes;
+        grid->cells = cells;
+
+        return true;
+    }
+
+static inline void sudoku_grid_free(sudoku_grid *grid)
+    {
+        if (!grid->view)
+            {
+                free(grid->cells);
+            }
+
+        grid->cells = NULL;
+        grid->size = 0;
+        grid->view = false;
+    }
+
+static inline void sudoku_grid_view(sudoku_grid *grid, int size, int cell_bytes, size_t stride, const void *cells)
+    {
+        // points grid at cells that live elsewhere. the values are used as they are, the kernels treat
+        // anything outside 1..N as invalid.
+
+        grid->size = size;
+        grid->cell_bytes = cell_bytes;
+        grid->stride = stride;
+        grid->cells = (void *)cells;
+        grid->view = true;
+    }
+
+static inline bool sudoku_grid_copy(sudoku_grid *dst, const sudoku_grid *src)
+    {
+        // deep copy of src into a freshly allocated dst
+
+        if (!sudoku_grid_init(dst, src->size))
+            {
+                return false;
+            }
+
+        size_t row_bytes = (size_t)src->size * src->cell_bytes;
+
+        for (int i = 0; i < src->size; i++)
+            {
+                // row by row, src may be a view with a different stride
+
+                memcpy((char *)dst->cells + i * dst->stride * dst->cell_bytes, (const char *)src->cells + i * src->stride * src->cell_bytes, row_bytes);
+            }
+
+        return true;
+    }
+
+static inline const uint8_t *sudoku_grid_row8(const sudoku_grid *grid, int row)
+    {
+        return (const uint8_t *)grid->cells + (size_t)row * grid->stride;
+    }
+
+static inline const uint16_t *sudoku_grid_row16(const sudoku_grid *grid, int row)
+    {
+        return (const uint16_t *)grid->cells + (size_t)row * grid->stride;
+    }
+
+static inline int sudoku_grid_get(const sudoku_grid *grid, int row, int col)
+    {
+        if (grid->cell_bytes == 1)
+            {
+                return sudoku_grid_row8(grid, row)[col];
+            }
+
+        return sudoku_grid_row16(grid, row)[col];
+    }
+
+static inline void sudoku_grid_set(sudoku_grid *grid, int row, int col, int value)
+    {
+        if (value < 1 || value > grid->size)
+            {
+                value = 0;
+            }
+
+        size_t at = (size_t)row * grid->stride + col;
+
+        if (grid->cell_bytes == 1)
+            {
+                ((uint8_t *)grid->cells)[at] = (uint8_t)value;
+            }
+
+        else
+            {
+                ((uint16_t *)grid->cells)[at] = (uint16_t)value;
+            }
+    }
+
+#endif
@@ -0,0 +1,404 @@
+#ifndef TASK_VALIDATOR_H
+#define TASK_VALIDATOR_H
+
+// the Assignment2 validator: K threads get ranges of the 3*N checks from a dispatch policy, check them,
+// and log what they do. run_task_validator<Dispatch> is the whole program for one policy, so the
+// programs only differ in how the ranges are handed out (a lock around the shared counter in
+// lock_dispatch.h, fetch_add, guided chunks or work stealing) and a fix to the rest is made once.
+//
+// a dispatch policy is a class with
+//     Dispatch(int threads, int size, int task_inc)   threads are numbered 0 .. threads - 1
+//     bool next(int thread, task_range *range, trace_buffer *trace)
+//                                                     the thread's next range, false once there is none.
+//                                                     what it did goes to trace with dispatch_log
+//     bool configure(int argc, char **argv)           reads its own command line options, if it has any.
+//                                                     false (after an ERROR: line) if they are unusable
+//     void place(int thread, pthread_attr_t *attr)    where the thread should run, set on attr before it is created
+//     void finished(int thread, double elapsed)       the thread stopped, elapsed microseconds after the start
+//     void report(std::ostream &out)                  extra lines after the times, if it has any
+//     bool csv(const char *path)                      extra --csv rows, false if they cannot be written
+//     static name, output, claim_what                 its name in --csv rows, the file the validator writes,
+//                                                     and what a claim is called in the report ("claim tasks")
+// task_policy supplies the empty configure, place, finished, report and csv.
+// C++ only (g++ -std=c++17).
+
+#include <iostream>
+#include <fstream>
+#include <pthread.h>
+#include <math.h>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <string>
+#include <sys/resource.h>
+
+#include "sudoku_check.h"
+#include "sudoku_cols.h"
+#include "grid_io.h"
+#include "cache_line.h"
+#include "grid_replica.h"
+#include "trace_log.h"
+#include "latency_histogram.h"
+
+struct task_range
+    {
+        // tasks [first, last) of the 3*N checks
+
+        int first;
+        int last;
+    };
+
+struct task_policy
+    {
+        bool configure(int /* argc */, char ** /* argv */) { return true; }
+        void place(int /* thread */, pthread_attr_t * /* attr */) {}
+        void finished(int /* thread */, double /* elapsed */) {}
+        void report(std::ostream & /* out */) {}
+        bool csv(const char * /* path */) { return true; }
+    };
+
+inline void dispatch_log(trace_buffer *trace, int thread, trace_event event, int index = 0, int last = 0, int from = 0)
+    {
+        // what a dispatch policy logs from next. trace is nullptr with --quiet
+
+        if (trace != nullptr)
+            {
+                trace_add(trace, thread + 1, event, index, last, from);
+            }
+    }
+
+template <class Dispatch>
+struct alignas(CACHE_LINE) task_inp
+    {
+        // struct that is passed into the thread function as argument.
+
+        const sudoku_grid *sudoku;      // the one grid all threads read, or the copy on this thread's NUMA node
+        bool *claimed_cols;     // verdicts of the columns in the current range, filled by one row by row sweep
+        Dispatch *dispatch;     // shared by all the threads
+        int N;
+        int t_id;
+        trace_buffer trace;             // what the thread did, formatted only after the joins
+        latency_histogram claim_times;      // ns from asking the dispatch policy for a range to getting it
+    };
+
+inline bool quiet = false;                          // --quiet: no per task messages, only the verdict and the times
+inline bool numa = false;                           // --numa: a copy of the grid per NUMA node, threads pinned to the node of their copy
+inline std::chrono::high_resolution_clock::time_point threads_start;
+
+alignas(CACHE_LINE) inline std::atomic<bool> valid{true};  // for the overall validity of Sudoku, shares its line with cancel_request
+inline std::atomic<bool> cancel_request{false};     // to track if any thread initiates cancellation of all the other threads.
+
+template <class Dispatch>
+void log_event(task_inp<Dispatch> *t, trace_event event, int index = 0, int last = 0, int from = 0, bool verdict = true)
+    {
+        // records "Thread <id> <event> at <time>" with the numbers of the event and the verdict of a check,
+        // trace_write turns it into text once the threads are done
+
+        if (quiet)
+            {
+                return;
+            }
+
+        trace_add(&t->trace, t->t_id, event, index, last, from, verdict);
+    }
+
+inline double cpu_time_us(double *user, double *system)
+    {
+        // cpu time used so far by all the threads of the process
+
+        struct rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+
+        *user = usage.ru_utime.tv_sec * 1e6 + usage.ru_utime.tv_usec;
+        *system = usage.ru_stime.tv_sec * 1e6 + usage.ru_stime.tv_usec;
+
+        return *user + *system;
+    }
+
+template <class Dispatch>
+bool run_tasks(task_inp<Dispatch> *t, task_range range)
+    {
+        // runs the checks of one range, false once the thread has to stop
+
+        for (int i = range.first; i < range.last; i++)
+            {
+                if (cancel_request.load())
+                    {
+                        // for early termination
+
+                        return false;
+                    }
+
+                if (i < t->N)
+                    {
+                        // checking rows
+
+                        log_event(t, TRACE_GRAB_ROW, i + 1);
+
+                        bool row_valid = sudoku_check_row(t->sudoku, i);
+
+                        if (!row_valid)
+                            {
+                                valid.store(false);
+                            }
+
+                        log_event(t, TRACE_CHECK_ROW, i + 1, 0, 0, row_valid);
+                    }
+
+                else if (i < 2*t->N)
+                    {
+                        // checking columns
+
+                        log_event(t, TRACE_GRAB_COLUMN, i - t->N + 1);
+
+                        int first_col = std::max(range.first, t->N);
+
+                        if (i == first_col)
+                            {
+                                // the columns of the range are contiguous, so they are all checked in one pass
+                                // when the first of them comes up
+
+                                int last_col = std::min(range.last, 2*t->N);
+                                sudoku_check_cols(t->sudoku, first_col - t->N, last_col - t->N, t->claimed_cols);
+                            }
+
+                        bool col_valid = t->claimed_cols[i - first_col];
+
+                        if (!col_valid)
+                            {
+                                valid.store(false);
+                            }
+
+                        log_event(t, TRACE_CHECK_COLUMN, i - t->N + 1, 0, 0, col_valid);
+                    }
+
+                else
+                    {
+                        // checking subgrids
+
+                        int grid = i - 2*t->N;
+                        int n = sqrt(t->N);
+
+                        int row = (grid/n) * n;
+                        int col = (grid%n) * n;
+
+                        int subgrid_no = (row/n) * n + (col/n) + 1;
+
+                        log_event(t, TRACE_GRAB_SUBGRID, subgrid_no);
+
+                        bool subgrid_valid = sudoku_check_subgrid(t->sudoku, row, col);
+
+                        if (!subgrid_valid)
+                            {
+                                valid.store(false);
+                            }
+
+                        log_event(t, TRACE_CHECK_SUBGRID, subgrid_no, 0, 0, subgrid_valid);
+                    }
+
+                if (!valid.load())
+                    {
+                        // if any thread finds any check as invalid then request for cancellation.
+
+                        cancel_request.store(true);
+                        return false;
+                    }
+            }
+
+        return true;
+    }
+
+template <class Dispatch>
+void* validate(void* param)
+    {
+        task_inp<Dispatch> *t = (task_inp<Dispatch> *)param;        // typecasting the input
+        bool running = !cancel_request.load();      // checks if any thread requested cancellation
+
+        while (running)
+            {
+                auto req_time = std::chrono::high_resolution_clock::now();
+
+                task_range range;
+
+                if (!t->dispatch->next(t->t_id - 1, &range, quiet ? nullptr : &t->trace))
+                    {
+                        // every range was handed out
+
+                        break;
+                    }
+
+                auto claim_time = std::chrono::high_resolution_clock::now();
+                latency_histogram_add(&t->claim_times, std::chrono::duration_cast<std::chrono::nanoseconds>(claim_time - req_time).count());
+
+                running = run_tasks(t, range);
+            }
+
+        t->dispatch->finished(t->t_id - 1, std::chrono::duration<double, std::micro>(std::chrono::high_resolution_clock::now() - threads_start).count());
+        return nullptr;
+    }
+
+template <class Dispatch>
+int run_task_validator(int argc, char **argv)
+    {
+        // the whole program for one dispatch policy: ./a.out [--quiet] [--numa] [--csv file] plus the
+        // policy's own options. reads inp.txt and writes Dispatch::output. --csv appends the claim time
+        // percentiles of the run to file as a row named after the policy, and the policy's own rows.
+
+        valid = true;
+        const char *csv_path = nullptr;
+
+        for (int i = 1; i < argc; i++)
+            {
+                quiet = quiet || std::string(argv[i]) == "--quiet";
+                numa = numa || std::string(argv[i]) == "--numa";
+
+                if (std::string(argv[i]) == "--csv" && i + 1 < argc)
+                    {
+                        csv_path = argv[i + 1];
+                    }
+            }
+
+        auto start_time = std::chrono::high_resolution_clock::now();
+
+        int N, taskInc, K;
+
+        sudoku_source inp;              // reading from input file, mapped and either text or the binary grid format
+        sudoku_header header;
+        sudoku_grid sudoku = {0, 1, 0, nullptr, false};    // read once, then shared by all the threads
+
+        if (!sudoku_source_open(&inp, "inp.txt") || sudoku_source_next(&inp, 3, &header, &sudoku) != 1)
+            {
+                std::cout << "ERROR: Invalid input format." << std::endl;
+                return -1;
+            }
+
+        K = header.threads;
+        N = header.size;
+        taskInc = header.task_inc;
+
+        Dispatch dispatch(K, N, taskInc);
+
+        if (!dispatch.configure(argc, argv))
+            {
+                sudoku_grid_free(&sudoku);
+                sudoku_source_close(&inp);
+                return -1;
+            }
+
+        grid_replicas replicas = {};                // --numa only, otherwise every thread shares sudoku
+
+        if (numa)
+            {
+                grid_replicas_init(&replicas, &sudoku);
+            }
+
+        auto read_time = std::chrono::high_resolution_clock::now();     // input read (and placed), the threads start now
+        threads_start = read_time;
+        double start_user, start_system;
+        double start_cpu = cpu_time_us(&start_user, &start_system);
+
+        std::vector <pthread_t> thread_ids(K);            // for thread ids
+        std::vector <task_inp<Dispatch>> tds(K);          // to send as arguments
+
+        for (int i = 0; i < K; i++)
+            {
+                pthread_attr_t attr;
+                pthread_attr_init(&attr);
+
+                tds[i].sudoku = (replicas.count > 0) ? grid_replicas_place(&replicas, i, &attr) : &sudoku;
+                dispatch.place(i, &attr);      // after the replica, so a policy that places its threads has the last word
+                tds[i].claimed_cols = new bool[N];      // a range never holds more than N columns
+                tds[i].dispatch = &dispatch;
+                tds[i].N = N;
+                tds[i].t_id = i + 1;
+                latency_histogram_clear(&tds[i].claim_times);
+
+                if (!quiet)
+                    {
+                        trace_reserve(&tds[i].trace, N, taskInc, K);      // so that logging seldom allocates while the threads run
+                    }
+
+                pthread_create(&thread_ids[i],&attr,validate<Dispatch>,&tds[i]);
+                pthread_attr_destroy(&attr);
+            }
+
+        for (int i = 0; i < K; i++)
+            {
+                pthread_join(thread_ids[i],nullptr);
+            }
+
+        auto end_time = std::chrono::high_resolution_clock::now();
+        double end_user, end_system;
+        double validation_cpu = cpu_time_us(&end_user, &end_system) - start_cpu;
+        double total_time = std::chrono::duration<double, std::micro>(end_time - start_time).count();
+
+        trace_buffer all_records;
+        for (int i = 0; i < K; i++)
+            {
+                // collecting all the messages from all the threads
+
+                all_records.insert(all_records.end(), tds[i].trace.begin(), tds[i].trace.end());
+            }
+
+        trace_sort(&all_records);      // sorting using timestamps
+
+        std::ofstream out(Dispatch::output);
+
+        trace_write(out, all_records);      // printing the logged messages
+
+        out << (valid.load()?"Valid Sudoku":"Invalid Sudoku") << std::endl;
+
+        auto write_time = std::chrono::high_resolution_clock::now();    // messages sorted and written
+
+        static latency_histogram claim_times;       // static: it is a few pages
+
+        latency_histogram_clear(&claim_times);
+
+        for (int i = 0; i < K; i++)
+            {
+                // merging the claim times of all the threads
+
+                latency_histogram_merge(&claim_times, &tds[i].claim_times);
+            }
+
+        char claim_percentiles[160];
+        latency_histogram_summary(&claim_times, claim_percentiles, sizeof(claim_percentiles));
+
+        double validation_time = std::chrono::duration<double, std::micro>(end_time - read_time).count();
+
+        // printing all the times
+
+        out << "Time taken to check the validity of the Sudoku: " << total_time << " microseconds" << std::endl;
+        out << "Time taken to read the input: " << std::chrono::duration<double, std::micro>(read_time - start_time).count() << " microseconds" << std::endl;
+        out << "Time taken for validation: " << validation_time << " microseconds" << std::endl;
+        out << "Time taken to write the messages: " << std::chrono::duration<double, std::micro>(write_time - end_time).count() << " microseconds" << std::endl;
+        out << "Task ranges claimed per second: " << (validation_time > 0 ? claim_times.count * 1e6 / validation_time : 0) << std::endl;
+        out << "Average time taken by a thread to " << Dispatch::claim_what << ": " << latency_histogram_mean(&claim_times) / 1000.0 << " microseconds" << std::endl;
+        out << "Worst-case time taken by a thread to " << Dispatch::claim_what << ": " << claim_times.max / 1000.0 << " microseconds" << std::endl;
+        out << "Time taken by a thread to " << Dispatch::claim_what << ": " << claim_percentiles << std::endl;
+        out << "CPU time used during validation: " << validation_cpu << " microseconds (user " << end_user - start_user << ", system " << end_system - start_system << ")" << std::endl;
+        out << "CPU time per wall time during validation: " << (validation_time > 0 ? validation_cpu / validation_time : 0) << std::endl;
+
+        dispatch.report(out);
+
+        out.close();
+
+        if (csv_path != nullptr && !(latency_histogram_csv(csv_path, Dispatch::name, "claim", &claim_times) && dispatch.csv(csv_path)))
+            {
+                std::cout << "ERROR: cannot append to " << csv_path << "." << std::endl;
+            }
+
+        for (int i = 0; i < K; i++)
+            {
+                delete[] tds[i].claimed_cols;
+            }
+
+        grid_replicas_free(&replicas);
+        sudoku_grid_free(&sudoku);
+        sudoku_source_close(&inp);
+
+        return 0;
+    }
+
+#endif
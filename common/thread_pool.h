@@ -0,0 +1,213 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+// fixed set of worker threads that is created once and fed tasks.
+//
+// a task is a function with the pthread start routine signature plus its argument, so any function
+// that was passed to pthread_create can be submitted as it is. thread_pool_wait blocks until every
+// task submitted so far has finished, which takes the place of the pthread_join loop.
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+typedef void *(*pool_task_fn)(void *);
+
+typedef struct
+    {
+        pool_task_fn fn;
+        void *arg;
+
+    } pool_task;
+
+typedef struct
+    {
+        pthread_t *t_ids;           // worker threads
+        int no_of_threads;
+
+        pthread_mutex_t lock;       // guards everything below
+        pthread_cond_t task_ready;  // signalled when a task is queued or the pool stops
+        pthread_cond_t all_done;    // signalled when pending drops to 0
+
+        pool_task *queue;           // ring buffer of tasks not yet picked up
+        int head;
+        int count;
+        int capacity;
+
+        int pending;                // tasks submitted and not yet finished
+        bool stop;
+
+    } thread_pool;
+
+static inline void *thread_pool_worker(void *param)
+    {
+        // runs tasks until the pool is stopped and the queue is empty
+
+        thread_pool *pool = (thread_pool *)param;
+
+        pthread_mutex_lock(&pool->lock);
+
+        while (true)
+            {
+                while (pool->count == 0 && !pool->stop)
+                    {
+                        pthread_cond_wait(&pool->task_ready, &pool->lock);
+                    }
+
+                if (pool->count == 0)
+                    {
+                        // stopped and drained
+
+                        break;
+                    }
+
+                pool_task task = pool->queue[pool->head];
+                pool->head = (pool->head + 1) % pool->capacity;
+                pool->count--;
+
+                pthread_mutex_unlock(&pool->lock);
+                task.fn(task.arg);
+                pthread_mutex_lock(&pool->lock);
+
+                if (--pool->pending == 0)
+                    {
+                        pthread_cond_broadcast(&pool->all_done);
+                    }
+            }
+
+        pthread_mutex_unlock(&pool->lock);
+        return NULL;
+    }
+
+static inline bool thread_pool_init(thread_pool *pool, int no_of_threads)
+    {
+        // starts no_of_threads workers (at least one). false if not even one started, and then there is
+        // nothing left for thread_pool_destroy to do
+
+        if (no_of_threads < 1)
+            {
+                no_of_threads = 1;
+            }
+
+        pool->no_of_threads = 0;
+        pool->head = 0;
+        pool->count = 0;
+        pool->capacity = 2 * no_of_threads;
+        pool->pending = 0;
+        pool->stop = false;
+
+        pool->t_ids = (pthread_t *)malloc(no_of_threads * sizeof(pthread_t));
+        pool->queue = (pool_task *)malloc(pool->capacity * sizeof(pool_task));
+
+        if (pool->t_ids == NULL || pool->queue == NULL)
+            {
+                free(pool->t_ids);
+                free(pool->queue);
+                return false;
+            }
+
+        pthread_mutex_init(&pool->lock, NULL);
+        pthread_cond_init(&pool->task_ready, NULL);
+        pthread_cond_init(&pool->all_done, NULL);
+
+        for (int i = 0; i < no_of_threads; i++)
+            {
+                if (pthread_create(&pool->t_ids[i], NULL, thread_pool_worker, pool) != 0)
+                    {
+                        break;
+                    }
+
+                pool->no_of_threads++;
+            }
+
+        if (pool->no_of_threads == 0)
+            {
+                // nothing to destroy later, so the pool is taken down here
+
+                pthread_mutex_destroy(&pool->lock);
+                pthread_cond_destroy(&pool->task_ready);
+                pthread_cond_destroy(&pool->all_done);
+                free(pool->t_ids);
+                free(pool->queue);
+                return false;
+            }
+
+        return true;
+    }
+
+static inline bool thread_pool_submit(thread_pool *pool, pool_task_fn fn, void *arg)
+    {
+        // queues one task, growing the ring buffer when it is full
+
+        pthread_mutex_lock(&pool->lock);
+
+        if (pool->count == pool->capacity)
+            {
+                int capacity = 2 * pool->capacity;
+                pool_task *queue = (pool_task *)malloc(capacity * sizeof(pool_task));
+
+                if (queue == NULL)
+                    {
+                        pthread_mutex_unlock(&pool->lock);
+                        return false;
+                    }
+
+                for (int i = 0; i < pool->count; i++)
+                    {
+                        queue[i] = pool->queue[(pool->head + i) % pool->capacity];
+                    }
+
+                free(pool->queue);
+                pool->queue = queue;
+                pool->head = 0;
+                pool->capacity = capacity;
+            }
+
+        pool->queue[(pool->head + pool->count) % pool->capacity].fn = fn;
+        pool->queue[(pool->head + pool->count) % pool->capacity].arg = arg;
+        pool->count++;
+        pool->pending++;
+
+        pthread_cond_signal(&pool->task_ready);
+        pthread_mutex_unlock(&pool->lock);
+
+        return true;
+    }
+
+static inline void thread_pool_wait(thread_pool *pool)
+    {
+        // blocks until every submitted task has finished
+
+        pthread_mutex_lock(&pool->lock);
+
+        while (pool->pending > 0)
+            {
+                pthread_cond_wait(&pool->all_done, &pool->lock);
+            }
+
+        pthread_mutex_unlock(&pool->lock);
+    }
+
+static inline void thread_pool_destroy(thread_pool *pool)
+    {
+        // lets the workers finish the queue, then joins them
+
+        pthread_mutex_lock(&pool->lock);
+        pool->stop = true;
+        pthread_cond_broadcast(&pool->task_ready);
+        pthread_mutex_unlock(&pool->lock);
+
+        for (int i = 0; i < pool->no_of_threads; i++)
+            {
+                pthread_join(pool->t_ids[i], NULL);
+            }
+
+        pthread_mutex_destroy(&pool->lock);
+        pthread_cond_destroy(&pool->task_ready);
+        pthread_cond_destroy(&pool->all_done);
+
+        free(pool->t_ids);
+        free(pool->queue);
+    }
+
+#endif
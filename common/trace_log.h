@@ -0,0 +1,125 @@
+#ifndef TRACE_LOG_H
+#define TRACE_LOG_H
+
+// the per task messages of the Assignment2 validators, kept as small binary records while the threads
+// run and only turned into text once they are joined.
+//
+// a record is the time, the thread, what happened and up to three numbers, so logging an event is a
+// clock read and a store into the thread's own buffer, with no string built and no localtime call,
+// several of which used to happen while the CS lock was held. after the joins the caller merges the
+// buffers, orders them with trace_sort, and trace_write formats them into the same lines the programs
+// have always written.
+// C++ only (g++ -std=c++17).
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <ostream>
+#include <vector>
+
+enum trace_event : uint8_t
+    {
+        TRACE_REQUEST,          // requests to enter CS
+        TRACE_ENTER,            // entered CS
+        TRACE_LEAVE,            // leaves CS
+        TRACE_CLAIM,            // claims tasks <index> to <last>
+        TRACE_TAKE,             // takes tasks <index> to <last>
+        TRACE_STEAL,            // steals tasks <index> to <last> from thread <from>
+        TRACE_GRAB_ROW,         // grabs row <index>
+        TRACE_GRAB_COLUMN,
+        TRACE_GRAB_SUBGRID,
+        TRACE_CHECK_ROW,        // completes checking row <index> and finds it as <valid>
+        TRACE_CHECK_COLUMN,
+        TRACE_CHECK_SUBGRID
+    };
+
+struct trace_record
+    {
+        std::chrono::system_clock::time_point timestamp;
+        int32_t thread;
+        trace_event event;
+        bool valid;             // verdict of the TRACE_CHECK_* events
+        int32_t index;          // 1 based row, column, subgrid or first task
+        int32_t last;
+        int32_t from;
+    };
+
+typedef std::vector<trace_record> trace_buffer;
+
+static inline void trace_reserve(trace_buffer *buffer, int size, int task_inc, int threads)
+    {
+        // room for twice this thread's share of the events: two per task and up to three per claim, so
+        // a thread only grows its buffer in a run where it does far more than its share
+
+        long tasks = 3L * size;
+        long claims = tasks / std::max(task_inc, 1) + 1;
+        long share = (2 * tasks + 3 * claims) / std::max(threads, 1) + 16;
+
+        buffer->reserve(2 * share);
+    }
+
+static inline void trace_add(trace_buffer *buffer, int thread, trace_event event, int index = 0, int last = 0, int from = 0, bool valid = true)
+    {
+        buffer->push_back({std::chrono::system_clock::now(), thread, event, valid, index, last, from});
+    }
+
+static inline void trace_sort(trace_buffer *records)
+    {
+        // by time, events of the same time in the order they were merged
+
+        std::stable_sort(records->begin(), records->end(), [](const trace_record &a, const trace_record &b) { return a.timestamp < b.timestamp; });
+    }
+
+static inline void trace_write(std::ostream &out, const trace_buffer &records)
+    {
+        // "Thread <id> <event> at HH:MM:SS.uuuuuu", local time. localtime is called once per second of
+        // records rather than once per record.
+
+        time_t cached_second = (time_t)-1;
+        tm local_time = {};
+        char line[160];
+
+        for (const trace_record &r : records)
+            {
+                auto us = std::chrono::duration_cast<std::chrono::microseconds>(r.timestamp.time_since_epoch()) % 1000000;
+                time_t second = std::chrono::system_clock::to_time_t(r.timestamp);
+
+                if (second != cached_second)
+                    {
+                        localtime_r(&second, &local_time);
+                        cached_second = second;
+                    }
+
+                int n = snprintf(line, sizeof(line), "Thread %d ", (int)r.thread);
+
+                switch (r.event)
+                    {
+                        case TRACE_REQUEST:         n += snprintf(line + n, sizeof(line) - n, "requests to enter CS"); break;
+                        case TRACE_ENTER:           n += snprintf(line + n, sizeof(line) - n, "entered CS"); break;
+                        case TRACE_LEAVE:           n += snprintf(line + n, sizeof(line) - n, "leaves CS"); break;
+                        case TRACE_CLAIM:           n += snprintf(line + n, sizeof(line) - n, "claims tasks %d to %d", r.index, r.last); break;
+                        case TRACE_TAKE:            n += snprintf(line + n, sizeof(line) - n, "takes tasks %d to %d", r.index, r.last); break;
+                        case TRACE_STEAL:           n += snprintf(line + n, sizeof(line) - n, "steals tasks %d to %d from thread %d", r.index, r.last, r.from); break;
+                        case TRACE_GRAB_ROW:        n += snprintf(line + n, sizeof(line) - n, "grabs row %d", r.index); break;
+                        case TRACE_GRAB_COLUMN:     n += snprintf(line + n, sizeof(line) - n, "grabs column %d", r.index); break;
+                        case TRACE_GRAB_SUBGRID:    n += snprintf(line + n, sizeof(line) - n, "grabs subgrid %d", r.index); break;
+                        case TRACE_CHECK_ROW:       n += snprintf(line + n, sizeof(line) - n, "completes checking row %d", r.index); break;
+                        case TRACE_CHECK_COLUMN:    n += snprintf(line + n, sizeof(line) - n, "completes checking column %d", r.index); break;
+                        case TRACE_CHECK_SUBGRID:   n += snprintf(line + n, sizeof(line) - n, "completes checking subgrid %d", r.index); break;
+                    }
+
+                n += snprintf(line + n, sizeof(line) - n, " at %02d:%02d:%02d.%06d", local_time.tm_hour, local_time.tm_min, local_time.tm_sec, (int)us.count());
+
+                if (r.event >= TRACE_CHECK_ROW)
+                    {
+                        n += snprintf(line + n, sizeof(line) - n, " and finds it as %s", r.valid ? "valid" : "invalid");
+                    }
+
+                line[n++] = '\n';
+                out.write(line, n);
+            }
+    }
+
+#endif
@@ -0,0 +1,203 @@
+// converts between the text input format (inp.txt) and the binary grid format of common/grid_io.h.
+// the direction is picked from the input: text becomes binary and binary becomes text.
+//
+// build: gcc -O2 -o sudoku_convert tools/sudoku_convert.c
+// usage: ./sudoku_convert [-f 2|3] [--packed] <input> <output>
+//     -f 2      the text has a "K N" header (Assignment1), the default -f 3 is "K N taskInc" (Assignment2)
+//     --packed  store rows back to back instead of padding each one to a cache line. smaller for 9 x 9
+//               batches, but the mapped grids then skip the vector column paths.
+//
+// a text file with several puzzles becomes one binary file, all puzzles must have the same N and the
+// header keeps K and taskInc of the first one. numbers outside 1..N are stored (and written back) as 0.
+//
+// the output is written to <output>.tmp and only renamed to <output> once the whole input converted, so
+// a malformed or empty input never leaves a half written file (with a zeroed binary header) behind.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../common/grid_io.h"
+
+static int text_to_binary(sudoku_source *src, int fields, bool packed, FILE *out)
+    {
+        sudoku_bin_header bin;
+        memset(&bin, 0, sizeof(bin));
+        memcpy(bin.magic, SUDOKU_BIN_MAGIC, 4);
+        bin.version = SUDOKU_BIN_VERSION;
+        bin.fields = fields;
+
+        // the header is written again at the end, once the count is known
+        fwrite(&bin, sizeof(bin), 1, out);
+
+        sudoku_grid grid = {0, 1, 0, NULL, false};
+        sudoku_header header;
+        int read;
+
+        while ((read = sudoku_source_next(src, fields, &header, &grid)) == 1)
+            {
+                if (bin.count == 0)
+                    {
+                        bin.threads = header.threads;
+                        bin.size = header.size;
+                        bin.task_inc = header.task_inc;
+                        bin.cell_bytes = grid.cell_bytes;
+                        bin.stride = packed ? (uint32_t)grid.size : (uint32_t)grid.stride;
+                    }
+
+                else if ((uint32_t)header.size != bin.size)
+                    {
+                        printf("ERROR: puzzle %llu has N = %d, the first one has N = %u.\n", (unsigned long long)bin.count + 1, header.size, bin.size);
+                        sudoku_grid_free(&grid);
+                        return -1;
+                    }
+
+                size_t row_bytes = (size_t)bin.stride * grid.cell_bytes;
+
+                for (int i = 0; i < grid.size; i++)
+                    {
+                        fwrite((const char *)grid.cells + i * grid.stride * grid.cell_bytes, 1, row_bytes, out);
+                    }
+
+                bin.count++;
+            }
+
+        sudoku_grid_free(&grid);
+
+        if (read < 0)
+            {
+                printf("ERROR: puzzle %llu is malformed.\n", (unsigned long long)bin.count + 1);
+                return -1;
+            }
+
+        if (bin.count == 0)
+            {
+                // every reader rejects a binary file without grids, so none is written
+
+                printf("ERROR: the input has no puzzles.\n");
+                return -1;
+            }
+
+        fseek(out, 0, SEEK_SET);
+        fwrite(&bin, sizeof(bin), 1, out);
+
+        printf("wrote %llu grids of %u x %u.\n", (unsigned long long)bin.count, bin.size, bin.size);
+        return 0;
+    }
+
+static int binary_to_text(sudoku_source *src, FILE *out)
+    {
+        sudoku_grid grid = {0, 1, 0, NULL, false};
+        sudoku_header header;
+        unsigned long long count = 0;
+
+        while (sudoku_source_next(src, (int)src->bin.fields, &header, &grid) == 1)
+            {
+                if (src->bin.fields >= 3)
+                    {
+                        fprintf(out, "%d %d %d\n", header.threads, header.size, header.task_inc);
+                    }
+
+                else
+                    {
+                        fprintf(out, "%d %d\n", header.threads, header.size);
+                    }
+
+                for (int i = 0; i < grid.size; i++)
+                    {
+                        for (int j = 0; j < grid.size; j++)
+                            {
+                                fprintf(out, (j + 1 < grid.size) ? "%d " : "%d\n", sudoku_grid_get(&grid, i, j));
+                            }
+                    }
+
+                count++;
+            }
+
+        sudoku_grid_free(&grid);
+
+        printf("wrote %llu grids of %u x %u.\n", count, src->bin.size, src->bin.size);
+        return 0;
+    }
+
+int main(int argc, char **argv)
+    {
+        int fields = 3;
+        bool packed = false;
+        const char *paths[2] = {NULL, NULL};
+        int no_of_paths = 0;
+
+        for (int i = 1; i < argc; i++)
+            {
+                if (strcmp(argv[i], "-f") == 0 && i + 1 < argc)
+                    {
+                        fields = atoi(argv[++i]);
+                    }
+
+                else if (strcmp(argv[i], "--packed") == 0)
+                    {
+                        packed = true;
+                    }
+
+                else if (no_of_paths < 2)
+                    {
+                        paths[no_of_paths++] = argv[i];
+                    }
+            }
+
+        if (no_of_paths != 2 || (fields != 2 && fields != 3))
+            {
+                printf("usage: %s [-f 2|3] [--packed] <input> <output>\n", argv[0]);
+                return -1;
+            }
+
+        sudoku_source src;
+
+        if (!sudoku_source_open(&src, paths[0]))
+            {
+                printf("ERROR: Something went wrong opening %s\n", paths[0]);
+                return -1;
+            }
+
+        char *temp_path = (char *)malloc(strlen(paths[1]) + 5);
+        sprintf(temp_path, "%s.tmp", paths[1]);
+
+        FILE *out = fopen(temp_path, src.binary ? "w" : "wb");
+
+        if (out == NULL)
+            {
+                printf("ERROR: Something went wrong opening %s\n", temp_path);
+                free(temp_path);
+                sudoku_source_close(&src);
+                return -1;
+            }
+
+        int status = src.binary ? binary_to_text(&src, out) : text_to_binary(&src, fields, packed, out);
+
+        if (ferror(out))
+            {
+                printf("ERROR: Something went wrong writing %s\n", temp_path);
+                status = -1;
+            }
+
+        if (fclose(out) != 0)
+            {
+                status = -1;
+            }
+
+        if (status == 0 && rename(temp_path, paths[1]) != 0)
+            {
+                printf("ERROR: Something went wrong renaming %s to %s\n", temp_path, paths[1]);
+                status = -1;
+            }
+
+        if (status != 0)
+            {
+                unlink(temp_path);      // the output is left as it was
+            }
+
+        free(temp_path);
+        sudoku_source_close(&src);
+
+        return status;
+    }